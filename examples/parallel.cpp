@@ -0,0 +1,185 @@
+/*****************************************************************************
+
+  Utility functions for vtzero example programs working on many tiles in
+  parallel.
+
+*****************************************************************************/
+
+#include "parallel.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+# include <dirent.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#ifndef _WIN32
+static void add_files(const std::string& name, std::vector<std::string>& files) {
+    struct stat s; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    if (::stat(name.c_str(), &s) != 0) {
+        throw std::runtime_error{std::string{"Can not open file '"} + name + "'"};
+    }
+
+    if (!S_ISDIR(s.st_mode)) {
+        files.push_back(name);
+        return;
+    }
+
+    DIR* dir = ::opendir(name.c_str());
+    if (!dir) {
+        throw std::runtime_error{std::string{"Can not open directory '"} + name + "'"};
+    }
+
+    std::vector<std::string> entries;
+    while (const struct dirent* entry = ::readdir(dir)) {
+        const std::string entry_name{entry->d_name};
+        if (!entry_name.empty() && entry_name[0] != '.') {
+            entries.push_back(name + '/' + entry_name);
+        }
+    }
+    ::closedir(dir);
+
+    std::sort(entries.begin(), entries.end());
+    for (const auto& entry : entries) {
+        add_files(entry, files);
+    }
+}
+#endif
+
+/**
+ * Get the names of all files given on the command line. Directories are
+ * read recursively (not on Windows), files starting with a dot are ignored.
+ *
+ * @param names The file and directory names.
+ * @returns a vector with the file names.
+ * @throws std::runtime_error if a file or directory can not be opened.
+ */
+std::vector<std::string> find_files(const std::vector<std::string>& names) {
+#ifdef _WIN32
+    return names;
+#else
+    std::vector<std::string> files;
+    for (const auto& name : names) {
+        add_files(name, files);
+    }
+    return files;
+#endif
+}
+
+/**
+ * Get the number of threads to use if the user didn't specify it.
+ */
+unsigned int default_num_threads() {
+    const auto num = std::thread::hardware_concurrency();
+    return num == 0 ? 1 : num;
+}
+
+/**
+ * Call a function for each of the numbers 0 to count-1 using a pool of
+ * threads. Each thread takes the next number as soon as it is done with
+ * the previous one, so the work is spread evenly even if items take very
+ * different amounts of time.
+ *
+ * @param count The number of items.
+ * @param num_threads The number of threads to use.
+ * @param func The function to call. It gets the item number and the
+ *             number of the thread (0 to num_threads-1) which can be
+ *             used to access per-thread data.
+ * @throws The first exception thrown by the function (after all threads
+ *         are finished).
+ */
+void run_in_parallel(std::size_t count, unsigned int num_threads, const std::function<void(std::size_t, unsigned int)>& func) {
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&](unsigned int thread_num) {
+        for (std::size_t n = next++; n < count; n = next++) {
+            try {
+                func(n, thread_num);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{error_mutex};
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+
+    if (num_threads <= 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < num_threads; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Map a file into memory.
+ *
+ * @param filename The file name.
+ * @throws std::runtime_error if the file can not be opened or mapped.
+ */
+mapped_file::mapped_file(const std::string& filename) {
+#ifdef _WIN32
+    m_buffer = read_file(filename);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    const int fd = ::open(filename.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd < 0) {
+        throw std::runtime_error{std::string{"Can not open file '"} + filename + "'"};
+    }
+
+    struct stat s; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    if (::fstat(fd, &s) != 0) {
+        ::close(fd);
+        throw std::runtime_error{std::string{"Can not open file '"} + filename + "'"};
+    }
+
+    m_size = static_cast<std::size_t>(s.st_size);
+    if (m_size == 0) { // can't map empty files
+        ::close(fd);
+        m_data = m_buffer.data();
+        return;
+    }
+
+    void* ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        throw std::runtime_error{std::string{"Can not map file '"} + filename + "'"};
+    }
+    m_data = static_cast<const char*>(ptr);
+#endif
+}
+
+mapped_file::~mapped_file() noexcept {
+#ifndef _WIN32
+    if (m_size > 0) {
+        ::munmap(const_cast<char*>(m_data), m_size); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+#endif
+}
+
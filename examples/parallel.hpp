@@ -0,0 +1,44 @@
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+std::vector<std::string> find_files(const std::vector<std::string>& names);
+
+unsigned int default_num_threads();
+
+void run_in_parallel(std::size_t count, unsigned int num_threads, const std::function<void(std::size_t, unsigned int)>& func);
+
+/**
+ * A file mapped into memory (read-only). On systems without mmap() the
+ * file is read into memory instead.
+ */
+class mapped_file {
+
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::string m_buffer;
+
+public:
+
+    explicit mapped_file(const std::string& filename);
+
+    ~mapped_file() noexcept;
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&&) = delete;
+    mapped_file& operator=(mapped_file&&) = delete;
+
+    const char* data() const noexcept {
+        return m_data;
+    }
+
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+}; // class mapped_file
+
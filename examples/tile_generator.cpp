@@ -0,0 +1,220 @@
+/*****************************************************************************
+
+  Synthetic tile generator for vtzero example programs and benchmarks.
+
+  The generator uses its own random number generator instead of the ones
+  from the standard library, because the distributions in the standard
+  library give different results on different implementations and the
+  tiles should be the same everywhere.
+
+*****************************************************************************/
+
+#include "tile_generator.hpp"
+
+#include <vtzero/builder.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr const double pi = 3.14159265358979323846;
+
+    /// The splitmix64 random number generator.
+    class random_generator {
+
+        uint64_t m_state;
+
+    public:
+
+        explicit random_generator(const uint64_t seed) noexcept :
+            m_state(seed) {
+        }
+
+        uint64_t next() noexcept {
+            uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27u)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31u);
+        }
+
+        /// Random number in the range [0, max).
+        uint32_t operator()(const uint32_t max) noexcept {
+            return static_cast<uint32_t>(next() % max);
+        }
+
+    }; // class random_generator
+
+    class layer_generator {
+
+        const generator_config& m_config;
+        random_generator m_random;
+        vtzero::layer_builder m_builder;
+        std::vector<vtzero::index_value> m_keys;
+        std::vector<vtzero::index_value> m_values;
+
+        int32_t coordinate() noexcept {
+            return static_cast<int32_t>(m_random(m_config.extent));
+        }
+
+        vtzero::index_value value(const uint32_t n) {
+            auto& v = m_values[n];
+            if (!v.valid()) {
+                // mix of value types, same value number means same value
+                switch (n % 4) {
+                    case 0:
+                        v = m_builder.add_value_without_dup_check(vtzero::encoded_property_value{"value-" + std::to_string(n)});
+                        break;
+                    case 1:
+                        v = m_builder.add_value_without_dup_check(vtzero::encoded_property_value{vtzero::uint_value_type{n}});
+                        break;
+                    case 2:
+                        v = m_builder.add_value_without_dup_check(vtzero::encoded_property_value{vtzero::sint_value_type{-static_cast<int64_t>(n)}});
+                        break;
+                    default:
+                        v = m_builder.add_value_without_dup_check(vtzero::encoded_property_value{vtzero::double_value_type{n + 0.5}});
+                        break;
+                }
+            }
+            return v;
+        }
+
+        template <typename TBuilder>
+        void add_id(TBuilder& fbuilder, const uint32_t n) {
+            switch (m_config.ids) {
+                case id_distribution::none:
+                    break;
+                case id_distribution::sequential:
+                    fbuilder.set_id(n + 1);
+                    break;
+                case id_distribution::random:
+                    fbuilder.set_id(m_random.next());
+                    break;
+            }
+        }
+
+        template <typename TBuilder>
+        void add_properties_and_commit(TBuilder& fbuilder) {
+            // the keys of a feature are consecutive (modulo the number of
+            // keys) from a random start, so they are all different
+            const auto start = m_config.keys > 0 ? m_random(m_config.keys) : 0;
+            for (uint32_t p = 0; p < m_config.properties; ++p) {
+                const auto key = m_keys[(start + p) % m_config.keys];
+                fbuilder.add_property(vtzero::index_value_pair{key, value(m_random(m_config.values))});
+            }
+            fbuilder.commit();
+        }
+
+        void add_point(const uint32_t n) {
+            vtzero::point_feature_builder fbuilder{m_builder};
+            add_id(fbuilder, n);
+            fbuilder.add_point(coordinate(), coordinate());
+            add_properties_and_commit(fbuilder);
+        }
+
+        void add_linestring(const uint32_t n) {
+            vtzero::linestring_feature_builder fbuilder{m_builder};
+            add_id(fbuilder, n);
+
+            // random walk, each step is at least one unit long
+            fbuilder.add_linestring(m_config.vertices);
+            vtzero::point p{coordinate(), coordinate()};
+            for (uint32_t i = 0; i < m_config.vertices; ++i) {
+                fbuilder.set_point(p);
+                p.x += static_cast<int32_t>(m_random(33)) - 16;
+                p.y += static_cast<int32_t>(m_random(16)) + 1;
+            }
+
+            add_properties_and_commit(fbuilder);
+        }
+
+        void add_polygon(const uint32_t n) {
+            vtzero::polygon_feature_builder fbuilder{m_builder};
+            add_id(fbuilder, n);
+
+            // points on a circle large enough that rounding never creates
+            // duplicate points
+            const auto num = m_config.vertices - 1;
+            const double radius = 2.0 * num + 16 + m_random(64);
+            const vtzero::point center{coordinate(), coordinate()};
+            fbuilder.add_ring(m_config.vertices);
+            vtzero::point first;
+            for (uint32_t i = 0; i < num; ++i) {
+                const double angle = 2.0 * pi * i / num;
+                const vtzero::point p{center.x + static_cast<int32_t>(std::lround(radius * std::cos(angle))),
+                                      center.y + static_cast<int32_t>(std::lround(radius * std::sin(angle)))};
+                if (i == 0) {
+                    first = p;
+                }
+                fbuilder.set_point(p);
+            }
+            fbuilder.set_point(first);
+
+            add_properties_and_commit(fbuilder);
+        }
+
+    public:
+
+        layer_generator(const generator_config& config, vtzero::tile_builder& tbuilder, const uint32_t layer_num) :
+            m_config(config),
+            m_random(config.seed * 0x100000001b3ULL + layer_num),
+            m_builder(tbuilder, "layer" + std::to_string(layer_num), 2, config.extent),
+            m_keys(config.keys),
+            m_values(config.values) {
+            for (uint32_t k = 0; k < config.keys; ++k) {
+                m_keys[k] = m_builder.add_key_without_dup_check("key" + std::to_string(k));
+            }
+        }
+
+        void generate() {
+            const auto total_weight = m_config.points_weight +
+                                      m_config.linestrings_weight +
+                                      m_config.polygons_weight;
+            for (uint32_t n = 0; n < m_config.features; ++n) {
+                const auto r = m_random(total_weight);
+                if (r < m_config.points_weight) {
+                    add_point(n);
+                } else if (r < m_config.points_weight + m_config.linestrings_weight) {
+                    add_linestring(n);
+                } else {
+                    add_polygon(n);
+                }
+            }
+        }
+
+    }; // class layer_generator
+
+} // anonymous namespace
+
+void generate_tile(const generator_config& config, vtzero::tile_builder& tbuilder) {
+    if (config.points_weight + config.linestrings_weight + config.polygons_weight == 0) {
+        throw std::invalid_argument{"at least one geometry type weight must be non-zero"};
+    }
+    if (config.vertices < 4) {
+        throw std::invalid_argument{"need at least 4 vertices per feature"};
+    }
+    if (config.properties > config.keys) {
+        throw std::invalid_argument{"number of properties can't be larger than number of keys"};
+    }
+    if (config.properties > 0 && config.values == 0) {
+        throw std::invalid_argument{"need at least one value if there are properties"};
+    }
+    if (config.extent == 0) {
+        throw std::invalid_argument{"extent must be larger than 0"};
+    }
+
+    for (uint32_t l = 0; l < config.layers; ++l) {
+        layer_generator generator{config, tbuilder, l};
+        generator.generate();
+    }
+}
+
+std::string generate_tile(const generator_config& config) {
+    vtzero::tile_builder tbuilder;
+    generate_tile(config, tbuilder);
+    return tbuilder.serialize();
+}
+
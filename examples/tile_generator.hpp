@@ -0,0 +1,81 @@
+#ifndef TILE_GENERATOR_HPP
+#define TILE_GENERATOR_HPP
+
+/*****************************************************************************
+
+  Synthetic tile generator for vtzero example programs and benchmarks.
+
+*****************************************************************************/
+
+#include <vtzero/builder.hpp>
+
+#include <cstdint>
+#include <string>
+
+/// How feature IDs are assigned by the tile generator.
+enum class id_distribution {
+    none,       ///< features don't have an ID
+    sequential, ///< IDs 1, 2, 3, ... in each layer
+    random      ///< random 64 bit IDs
+};
+
+/**
+ * Configuration for the tile generator. The same configuration always
+ * generates the same tile.
+ */
+struct generator_config {
+
+    /// Seed for the random number generator.
+    uint64_t seed = 1;
+
+    /// Number of layers.
+    uint32_t layers = 1;
+
+    /// Number of features in each layer.
+    uint32_t features = 100;
+
+    /// Relative weight of point features.
+    uint32_t points_weight = 1;
+
+    /// Relative weight of linestring features.
+    uint32_t linestrings_weight = 1;
+
+    /// Relative weight of polygon features.
+    uint32_t polygons_weight = 1;
+
+    /// Number of vertices in each linestring or polygon ring (at least 4).
+    uint32_t vertices = 10;
+
+    /// Number of properties of each feature (at most the number of keys).
+    uint32_t properties = 5;
+
+    /// Number of different keys in each layer.
+    uint32_t keys = 10;
+
+    /// Number of different values in each layer.
+    uint32_t values = 100;
+
+    /// How feature IDs are assigned.
+    id_distribution ids = id_distribution::sequential;
+
+    /// Extent of the layers.
+    uint32_t extent = 4096;
+
+}; // struct generator_config
+
+/**
+ * Generate the layers described by the config and add them to the tile
+ * builder.
+ *
+ * @throws std::invalid_argument if the config is invalid.
+ */
+void generate_tile(const generator_config& config, vtzero::tile_builder& tbuilder);
+
+/**
+ * Generate a tile described by the config.
+ *
+ * @throws std::invalid_argument if the config is invalid.
+ */
+std::string generate_tile(const generator_config& config);
+
+#endif // TILE_GENERATOR_HPP
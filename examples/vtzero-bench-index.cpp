@@ -0,0 +1,138 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-bench-index - Compare the table index policies of the layer builder
+
+  Rebuilds all layers of the tiles given on the command line with each of
+  the table index policies and reports the time needed. The summary at the
+  end groups the layers by the size of their key/value tables to show where
+  the small table stops being faster than the hash table. This is used to
+  find the default for the automatic policy.
+
+*****************************************************************************/
+
+#include "utils.hpp"
+
+#include <vtzero/builder.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static const std::array<vtzero::table_index_policy, 4> policies{{
+    vtzero::table_index_policy::automatic,
+    vtzero::table_index_policy::small_table,
+    vtzero::table_index_policy::flat_hash,
+    vtzero::table_index_policy::no_dedup
+}};
+
+static const std::array<const char*, 4> policy_names{{
+    "automatic", "small_table", "flat_hash", "no_dedup"
+}};
+
+// Upper bounds of the table sizes used for grouping layers in the summary.
+static const std::array<std::size_t, 7> buckets{{8, 16, 24, 32, 48, 64, 1000000}};
+
+static std::size_t rebuild_layer(const vtzero::layer& layer, const vtzero::table_index_policy policy) {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, layer.name(), layer.version(), layer.extent()};
+    lbuilder.set_table_index_policy(policy);
+
+    auto source = layer;
+    source.reset_feature();
+    while (auto feature = source.next_feature()) {
+        vtzero::geometry_feature_builder fbuilder{lbuilder};
+        if (feature.has_id()) {
+            fbuilder.set_id(feature.id());
+        }
+        fbuilder.set_geometry(feature.geometry());
+        while (auto property = feature.next_property()) {
+            fbuilder.add_property(property.key(), property.value());
+        }
+        fbuilder.commit();
+    }
+
+    return tbuilder.serialize().size();
+}
+
+// Sum of all output sizes, printed at the end so the compiler can't
+// optimize the work away.
+static std::size_t total_size = 0;
+
+static double time_layer(const vtzero::layer& layer, const vtzero::table_index_policy policy, const int iterations) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; ++n) {
+        total_size += rebuild_layer(layer, policy);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " [-n ITERATIONS] TILE...\n";
+        return 1;
+    }
+
+    int iterations = 100;
+    int arg = 1;
+    if (std::string{argv[1]} == "-n" && argc > 3) {
+        iterations = std::max(1, std::atoi(argv[2]));
+        arg = 3;
+    }
+
+    // time per policy for each bucket, number of layers in each bucket
+    std::vector<std::array<double, policies.size()>> bucket_times(buckets.size());
+    std::vector<int> bucket_count(buckets.size(), 0);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "layer keys values";
+    for (const auto* name : policy_names) {
+        std::cout << ' ' << name;
+    }
+    std::cout << " (microseconds per layer)\n";
+
+    for (; arg < argc; ++arg) {
+        const auto data = read_file(argv[arg]);
+        vtzero::vector_tile tile{data};
+
+        while (const auto layer = tile.next_layer()) {
+            const auto table_size = std::max(layer.key_table().size(), layer.value_table().size());
+            const auto bucket = static_cast<std::size_t>(std::lower_bound(buckets.begin(), buckets.end(), table_size) - buckets.begin());
+            ++bucket_count[bucket];
+
+            std::cout.write(layer.name().data(), static_cast<std::streamsize>(layer.name().size()));
+            std::cout << ' ' << layer.key_table().size() << ' ' << layer.value_table().size();
+            for (std::size_t p = 0; p < policies.size(); ++p) {
+                const auto t = time_layer(layer, policies[p], iterations);
+                bucket_times[bucket][p] += t;
+                std::cout << ' ' << t;
+            }
+            std::cout << '\n';
+        }
+    }
+
+    std::cout << "\nsummary by table size (microseconds per layer)\n";
+    std::size_t lower = 0;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        if (bucket_count[b] > 0) {
+            std::cout << lower << '-' << buckets[b] << " (" << bucket_count[b] << " layers)";
+            for (std::size_t p = 0; p < policies.size(); ++p) {
+                std::cout << ' ' << policy_names[p] << '=' << bucket_times[b][p] / bucket_count[b];
+            }
+            std::cout << '\n';
+        }
+        lower = buckets[b] + 1;
+    }
+
+    std::cout << "\n(" << total_size << " bytes written)\n";
+}
+
@@ -0,0 +1,550 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-bench - Benchmark the hot paths of vtzero
+
+  Runs a number of benchmarks over all tiles given on the command line and
+  reports the time per iteration, the throughput in MB of input tile data
+  and in features per second, and the number of memory allocations and
+  allocated kilobytes per iteration. The micro benchmarks each exercise one part of the library
+  (opening tiles, iterating over features, decoding geometries, ...), the
+  "roundtrip" benchmark copies all tiles feature by feature into new tiles
+  like a typical filtering program would do.
+
+  Use the "bench" target of the build system to run it on the test tiles
+  and (if available) the real-world tiles from the mvt-fixtures.
+
+*****************************************************************************/
+
+#include "utils.hpp"
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/property_mapper.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <clara.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count all allocations and allocated bytes done through the global
+// operator new. The benchmark is single-threaded, so there is no need for
+// atomics.
+static std::size_t allocation_count = 0;
+static std::size_t allocation_bytes = 0;
+
+// GCC sees the free() in the replaced operator delete after inlining and
+// thinks it doesn't match the new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        throw std::bad_alloc{};
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic pop
+#endif
+
+using tiles_type = std::vector<std::string>;
+
+// Sum of some numbers from all benchmarks, printed at the end so the
+// compiler can't optimize the work away.
+static std::size_t sink = 0;
+
+/**
+ * Geometry handler counting the points in a geometry.
+ */
+struct point_counter {
+
+    std::size_t count = 0;
+
+    void points_begin(const uint32_t /*count*/) const noexcept {
+    }
+
+    void points_point(const vtzero::point /*p*/) noexcept {
+        ++count;
+    }
+
+    void points_end() const noexcept {
+    }
+
+    void linestring_begin(const uint32_t /*count*/) const noexcept {
+    }
+
+    void linestring_point(const vtzero::point /*p*/) noexcept {
+        ++count;
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+    void ring_begin(const uint32_t /*count*/) const noexcept {
+    }
+
+    void ring_point(const vtzero::point /*p*/) noexcept {
+        ++count;
+    }
+
+    void ring_end(const vtzero::ring_type /*type*/) const noexcept {
+    }
+
+    std::size_t result() const noexcept {
+        return count;
+    }
+
+}; // struct point_counter
+
+/**
+ * Geometry handler writing a decoded geometry into one of the feature
+ * builders.
+ */
+template <typename TBuilder>
+struct builder_handler {
+
+    TBuilder& builder;
+
+    explicit builder_handler(TBuilder& b) :
+        builder(b) {
+    }
+
+    void points_begin(const uint32_t count) {
+        builder.add_points(count);
+    }
+
+    void points_point(const vtzero::point p) {
+        builder.set_point(p);
+    }
+
+    void points_end() const noexcept {
+    }
+
+    void linestring_begin(const uint32_t count) {
+        builder.add_linestring(count);
+    }
+
+    void linestring_point(const vtzero::point p) {
+        builder.set_point(p);
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+    void ring_begin(const uint32_t count) {
+        builder.add_ring(count);
+    }
+
+    void ring_point(const vtzero::point p) {
+        builder.set_point(p);
+    }
+
+    void ring_end(const vtzero::ring_type /*type*/) const noexcept {
+    }
+
+}; // struct builder_handler
+
+// Used for the builder_handler in place of the builders that don't have
+// all of the functions above.
+struct point_builder : vtzero::point_feature_builder {
+
+    using vtzero::point_feature_builder::point_feature_builder;
+
+    void add_linestring(const uint32_t /*count*/) {
+    }
+
+    void add_ring(const uint32_t /*count*/) {
+    }
+
+}; // struct point_builder
+
+struct linestring_builder : vtzero::linestring_feature_builder {
+
+    using vtzero::linestring_feature_builder::linestring_feature_builder;
+
+    void add_points(const uint32_t /*count*/) {
+    }
+
+    void add_ring(const uint32_t /*count*/) {
+    }
+
+}; // struct linestring_builder
+
+struct polygon_builder : vtzero::polygon_feature_builder {
+
+    using vtzero::polygon_feature_builder::polygon_feature_builder;
+
+    void add_points(const uint32_t /*count*/) {
+    }
+
+    void add_linestring(const uint32_t /*count*/) {
+    }
+
+}; // struct polygon_builder
+
+static std::size_t bench_open(const tiles_type& tiles) {
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        while (const auto layer = tile.next_layer()) {
+            sink += layer.num_features();
+        }
+    }
+    return 0;
+}
+
+static std::size_t bench_iterate(const tiles_type& tiles) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        while (auto layer = tile.next_layer()) {
+            while (const auto feature = layer.next_feature()) {
+                sink += feature.num_properties();
+                ++features;
+            }
+        }
+    }
+    return features;
+}
+
+struct value_visitor {
+
+    template <typename T>
+    std::size_t operator()(T value) const noexcept {
+        return static_cast<std::size_t>(value != T{});
+    }
+
+    std::size_t operator()(const vtzero::data_view value) const noexcept {
+        return value.size();
+    }
+
+}; // struct value_visitor
+
+static std::size_t bench_properties(const tiles_type& tiles) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        while (auto layer = tile.next_layer()) {
+            while (const auto feature = layer.next_feature()) {
+                feature.for_each_property([](const vtzero::property& p) {
+                    sink += p.key().size() + vtzero::apply_visitor(value_visitor{}, p.value());
+                    return true;
+                });
+                ++features;
+            }
+        }
+    }
+    return features;
+}
+
+static std::size_t bench_decode(const tiles_type& tiles, const vtzero::GeomType type) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        while (auto layer = tile.next_layer()) {
+            while (const auto feature = layer.next_feature()) {
+                if (feature.geometry_type() == type) {
+                    sink += vtzero::decode_geometry(feature.geometry(), point_counter{});
+                    ++features;
+                }
+            }
+        }
+    }
+    return features;
+}
+
+template <typename TBuilder>
+static std::size_t bench_build(const tiles_type& tiles, const vtzero::GeomType type) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            while (const auto feature = layer.next_feature()) {
+                if (feature.geometry_type() != type) {
+                    continue;
+                }
+                TBuilder fbuilder{lbuilder};
+                if (feature.has_id()) {
+                    fbuilder.set_id(feature.id());
+                }
+                try {
+                    vtzero::decode_geometry(feature.geometry(), builder_handler<TBuilder>{fbuilder});
+                } catch (const vtzero::geometry_exception&) {
+                    // geometries the builders don't allow are skipped
+                    continue;
+                }
+                feature.for_each_property([&fbuilder](const vtzero::property& p) {
+                    fbuilder.add_property(p);
+                    return true;
+                });
+                fbuilder.commit();
+                ++features;
+            }
+        }
+        sink += tbuilder.serialized_size();
+    }
+    return features;
+}
+
+static std::size_t bench_add_feature(const tiles_type& tiles) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            while (const auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature);
+                ++features;
+            }
+        }
+        sink += tbuilder.serialized_size();
+    }
+    return features;
+}
+
+static std::size_t bench_property_mapper(const tiles_type& tiles) {
+    std::size_t features = 0;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            vtzero::property_mapper mapper{layer, lbuilder};
+            while (const auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature, mapper);
+                ++features;
+            }
+        }
+        sink += tbuilder.serialized_size();
+    }
+    return features;
+}
+
+static std::vector<vtzero::tile_builder> build_tiles(const tiles_type& tiles) {
+    std::vector<vtzero::tile_builder> builders;
+    builders.reserve(tiles.size());
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        builders.emplace_back();
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{builders.back(), layer};
+            vtzero::property_mapper mapper{layer, lbuilder};
+            while (const auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature, mapper);
+            }
+        }
+    }
+    return builders;
+}
+
+static std::size_t bench_serialize(const std::vector<vtzero::tile_builder>& builders) {
+    for (const auto& tbuilder : builders) {
+        sink += tbuilder.serialize().size();
+    }
+    return 0;
+}
+
+static std::size_t bench_roundtrip(const tiles_type& tiles) {
+    std::size_t features = 0;
+    std::string output;
+    for (const auto& data : tiles) {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            vtzero::property_mapper mapper{layer, lbuilder};
+            while (const auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature, mapper);
+                ++features;
+            }
+        }
+        output.clear();
+        tbuilder.serialize(output);
+        sink += output.size();
+    }
+    return features;
+}
+
+struct benchmark {
+    const char* name;
+    std::function<std::size_t()> func;
+};
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> filenames;
+    std::string filter;
+    int iterations = 10;
+    bool list = false;
+    bool help = false;
+
+    const auto cli
+        = clara::Opt(iterations, "N")
+            ["-n"]["--iterations"]
+            ("run each benchmark N times (default: 10)")
+        | clara::Opt(filter, "NAME")
+            ["-b"]["--benchmark"]
+            ("only run benchmarks whose name contains NAME")
+        | clara::Opt(list)
+            ["-l"]["--list"]
+            ("list benchmarks and exit")
+        | clara::Help(help)
+        | clara::Arg(filenames, "TILE...")
+            ("vector tiles");
+
+    const auto result = cli.parse(clara::Args(argc, argv));
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << '\n';
+        return 1;
+    }
+
+    if (help) {
+        std::cout << cli
+                  << "\nBenchmark vtzero on the specified vector tiles.\n";
+        return 0;
+    }
+
+    if (iterations < 1) {
+        iterations = 1;
+    }
+
+    tiles_type tiles;
+    std::size_t total_bytes = 0;
+    for (const auto& filename : filenames) {
+        tiles.push_back(read_file(filename));
+        total_bytes += tiles.back().size();
+    }
+
+    std::vector<vtzero::tile_builder> builders;
+
+    const std::vector<benchmark> benchmarks = {
+        {"open",              [&]() { return bench_open(tiles); }},
+        {"iterate",           [&]() { return bench_iterate(tiles); }},
+        {"properties",        [&]() { return bench_properties(tiles); }},
+        {"decode_point",      [&]() { return bench_decode(tiles, vtzero::GeomType::POINT); }},
+        {"decode_linestring", [&]() { return bench_decode(tiles, vtzero::GeomType::LINESTRING); }},
+        {"decode_polygon",    [&]() { return bench_decode(tiles, vtzero::GeomType::POLYGON); }},
+        {"build_point",       [&]() { return bench_build<point_builder>(tiles, vtzero::GeomType::POINT); }},
+        {"build_linestring",  [&]() { return bench_build<linestring_builder>(tiles, vtzero::GeomType::LINESTRING); }},
+        {"build_polygon",     [&]() { return bench_build<polygon_builder>(tiles, vtzero::GeomType::POLYGON); }},
+        {"add_feature",       [&]() { return bench_add_feature(tiles); }},
+        {"property_mapper",   [&]() { return bench_property_mapper(tiles); }},
+        {"serialize",         [&]() { return bench_serialize(builders); }},
+        {"roundtrip",         [&]() { return bench_roundtrip(tiles); }}
+    };
+
+    if (list) {
+        for (const auto& b : benchmarks) {
+            std::cout << b.name << '\n';
+        }
+        return 0;
+    }
+
+    if (tiles.empty()) {
+        std::cerr << "Error in command line: Missing file name of vector tile to read\n";
+        return 1;
+    }
+
+    try {
+        builders = build_tiles(tiles);
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading tiles: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::cout << tiles.size() << " tiles, " << total_bytes << " bytes, "
+              << iterations << " iterations\n\n";
+
+    std::cout << std::left << std::setw(18) << "benchmark" << std::right
+              << std::setw(12) << "ms/iter"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "features/s"
+              << std::setw(14) << "allocs/iter"
+              << std::setw(14) << "alloc KB/iter" << '\n';
+
+    std::cout << std::fixed;
+    for (const auto& b : benchmarks) {
+        if (std::string{b.name}.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        std::size_t features = 0;
+        std::size_t allocations = 0;
+        std::size_t allocated_bytes = 0;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+        try {
+            // warm up caches and branch predictors
+            b.func();
+
+            const auto allocations_before = allocation_count;
+            const auto allocated_bytes_before = allocation_bytes;
+            start = std::chrono::steady_clock::now();
+            for (int n = 0; n < iterations; ++n) {
+                features += b.func();
+            }
+            end = std::chrono::steady_clock::now();
+            allocations = allocation_count - allocations_before;
+            allocated_bytes = allocation_bytes - allocated_bytes_before;
+        } catch (const std::exception& e) {
+            std::cerr << "Error in benchmark " << b.name << ": " << e.what() << '\n';
+            return 1;
+        }
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        const double mbytes = static_cast<double>(total_bytes) * iterations / (1024.0 * 1024.0);
+
+        std::cout << std::left << std::setw(18) << b.name << std::right
+                  << std::setprecision(3) << std::setw(12) << (seconds * 1000.0 / iterations)
+                  << std::setprecision(1) << std::setw(12) << (seconds > 0 ? mbytes / seconds : 0.0);
+        if (features > 0) {
+            std::cout << std::setprecision(0) << std::setw(14) << (static_cast<double>(features) / seconds);
+        } else {
+            std::cout << std::setw(14) << '-';
+        }
+        std::cout << std::setprecision(1) << std::setw(14) << (static_cast<double>(allocations) / iterations)
+                  << std::setw(14) << (static_cast<double>(allocated_bytes) / 1024.0 / iterations) << '\n';
+    }
+
+    std::cout << "\n(checksum " << sink << ")\n";
+}
+
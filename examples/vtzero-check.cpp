@@ -4,75 +4,139 @@
 
   vtzero-check - Check vector tiles for validity
 
+  Checks one or many tiles. Directories given on the command line are read
+  recursively, more file names can be read from a file. In batch mode (more
+  than one tile) the tiles are checked in parallel and a summary with the
+  number of tiles with warnings and errors and the number of times each
+  kind of problem was found is printed, optionally as JSON.
+
 *****************************************************************************/
 
+#include "parallel.hpp"
 #include "utils.hpp"
 
 #include <vtzero/vector_tile.hpp>
 
+#include <clara.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
+
+enum result_level : int {
+    ok          = 0,
+    warning     = 1,
+    error       = 2,
+    fatal_error = 3
+};
+
+// Thrown to stop checking a tile after the first error.
+struct stop_check {
+};
+
+// The result of checking one tile.
+class check_result {
+
+    std::vector<std::string> m_messages;
+    std::map<std::string, uint64_t> m_classes;
+    int m_return_code = ok;
+    bool m_stop_at_error;
+
+    void add(const int level, const char* type, const std::string& context, const std::string& message, const std::string& cls) {
+        if (m_return_code < level) {
+            m_return_code = level;
+        }
+        m_messages.push_back(std::string{type} + context + ": " + message);
+        ++m_classes[std::string{type} + ": " + (cls.empty() ? message : cls)];
+        if (level >= error && m_stop_at_error) {
+            throw stop_check{};
+        }
+    }
 
-class result {
+public:
 
-    int m_return_code = 0;
+    explicit check_result(bool stop_at_error) noexcept :
+        m_stop_at_error(stop_at_error) {
+    }
 
-public:
+    // The class is used for counting warnings and errors of the same kind,
+    // it defaults to the message.
+    void add_warning(const std::string& context, const std::string& message, const std::string& cls = "") {
+        add(warning, "Warning", context, message, cls);
+    }
 
-    void has_warning() noexcept {
-        if (m_return_code < 1) {
-            m_return_code = 1;
-        }
+    void add_error(const std::string& context, const std::string& message, const std::string& cls = "") {
+        add(error, "Error", context, message, cls);
     }
 
-    void has_error() noexcept {
-        if (m_return_code < 2) {
-            m_return_code = 2;
+    void add_fatal_error(const std::string& context, const std::string& message) {
+        // Use message without numbers as class, they often contain the
+        // offending value.
+        std::string cls;
+        for (const char c : message) {
+            if (std::isdigit(static_cast<unsigned char>(c))) {
+                if (cls.empty() || cls.back() != 'N') {
+                    cls += 'N';
+                }
+            } else {
+                cls += c;
+            }
+        }
+        if (m_return_code < fatal_error) {
+            m_return_code = fatal_error;
         }
+        m_messages.push_back("Fatal error" + context + ": " + message);
+        ++m_classes["Fatal error: " + cls];
     }
 
-    void has_fatal_error() noexcept {
-        if (m_return_code < 3) {
-            m_return_code = 3;
-        }
+    const std::vector<std::string>& messages() const noexcept {
+        return m_messages;
+    }
+
+    const std::map<std::string, uint64_t>& classes() const noexcept {
+        return m_classes;
     }
 
     int return_code() const noexcept {
         return m_return_code;
     }
 
-} result;
+}; // class check_result
 
 class CheckGeomHandler {
 
     vtzero::point m_prev_point{};
+    check_result* m_result;
     int m_layer_num;
     int m_feature_num;
     int64_t m_extent;
     bool m_is_first_point = false;
     int m_count = 0;
 
-    void print_context() const {
-        std::cerr << " in layer " << m_layer_num
-                  << " in feature " << m_feature_num
-                  << " in geometry " << m_count
-                  << ": ";
+    std::string context() const {
+        return " in layer " + std::to_string(m_layer_num) +
+               " in feature " + std::to_string(m_feature_num) +
+               " in geometry " + std::to_string(m_count);
     }
 
     void print_error(const char* message) const {
-        result.has_error();
-        std::cerr << "Error";
-        print_context();
-        std::cerr << message << '\n';
+        m_result->add_error(context(), message);
     }
 
     void print_warning(const char* message) const {
-        result.has_warning();
-        std::cerr << "Warning";
-        print_context();
-        std::cerr << message << '\n';
+        m_result->add_warning(context(), message);
     }
 
     void check_point_location(const vtzero::point point) const {
@@ -86,7 +150,8 @@ class CheckGeomHandler {
 
 public:
 
-    CheckGeomHandler(uint32_t extent, int layer_num, int feature_num) :
+    CheckGeomHandler(check_result& res, uint32_t extent, int layer_num, int feature_num) :
+        m_result(&res),
         m_layer_num(layer_num),
         m_feature_num(feature_num),
         m_extent(static_cast<int64_t>(extent)) {
@@ -164,15 +229,7 @@ public:
 
 }; // class CheckGeomHandler
 
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " TILE\n";
-        return 1;
-    }
-
-    std::string input_file{argv[1]};
-    const auto data = read_file(input_file);
-
+static void check_tile(const vtzero::data_view data, check_result& res) {
     std::set<std::string> layer_names;
 
     vtzero::vector_tile tile{data};
@@ -181,45 +238,258 @@ int main(int argc, char* argv[]) {
     int feature_num = -1;
     try {
         while (auto layer = tile.next_layer()) {
+            const std::string layer_context{" in layer " + std::to_string(layer_num)};
             if (layer.name().empty()) {
-                std::cerr << "Error in layer " << layer_num << ": name is empty (spec 4.1)\n";
-                result.has_error();
+                res.add_error(layer_context, "name is empty (spec 4.1)");
             }
 
             std::string name(layer.name());
             if (layer_names.count(name) > 0) {
-                std::cerr << "Error in layer " << layer_num << ": name is duplicate of previous layer ('" << name << "') (spec 4.1)\n";
-                result.has_error();
+                res.add_error(layer_context, "name is duplicate of previous layer ('" + name + "') (spec 4.1)",
+                              "name is duplicate of previous layer (spec 4.1)");
             }
 
             layer_names.insert(name);
 
             feature_num = 0;
             while (auto feature = layer.next_feature()) {
-                CheckGeomHandler handler{layer.extent(), layer_num, feature_num};
+                CheckGeomHandler handler{res, layer.extent(), layer_num, feature_num};
                 vtzero::decode_geometry(feature.geometry(), handler);
                 ++feature_num;
             }
             if (feature_num == 0) {
-                std::cerr << "Warning: No features in layer " << layer_num << " (spec 4.1)\n";
-                result.has_warning();
+                res.add_warning("", "No features in layer " + std::to_string(layer_num) + " (spec 4.1)",
+                                "No features in layer (spec 4.1)");
             }
             feature_num = -1;
             ++layer_num;
         }
         if (layer_num == 0) {
-            std::cerr << "Warning: No layers in vector tile (spec 4.1)\n";
-            result.has_warning();
+            res.add_warning("", "No layers in vector tile (spec 4.1)");
         }
+    } catch (const stop_check&) {
     } catch (const std::exception& e) {
-        std::cerr << "Fatal error in layer " << layer_num;
+        std::string context{" in layer " + std::to_string(layer_num)};
         if (feature_num >= 0) {
-            std::cerr << " in feature " << feature_num;
+            context += " in feature " + std::to_string(feature_num);
+        }
+        res.add_fatal_error(context, e.what());
+    }
+}
+
+// Summary of the results of all tiles.
+struct summary {
+
+    std::array<uint64_t, 4> tiles{};
+    std::map<std::string, uint64_t> classes;
+    std::vector<std::pair<std::string, int>> failed; // files with errors
+    int return_code = ok;
+
+    void add(const std::string& filename, const check_result& res) {
+        ++tiles[static_cast<std::size_t>(res.return_code())];
+        for (const auto& c : res.classes()) {
+            classes[c.first] += c.second;
+        }
+        if (res.return_code() >= error) {
+            failed.emplace_back(filename, res.return_code());
+        }
+        return_code = std::max(return_code, res.return_code());
+    }
+
+}; // struct summary
+
+static std::string json_string(const std::string& str) {
+    std::string out{"\""};
+    for (const char c : str) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* hex = "0123456789abcdef";
+                    out += "\\u00";
+                    out += hex[(static_cast<unsigned char>(c) >> 4u) & 0xfu];
+                    out += hex[static_cast<unsigned char>(c) & 0xfu];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+static const char* level_name(const int level) noexcept {
+    static const char* names[] = {"ok", "warning", "error", "fatal_error"};
+    return names[level];
+}
+
+static void print_summary(const summary& sum) {
+    std::cout << "tiles: " << (sum.tiles[ok] + sum.tiles[warning] + sum.tiles[error] + sum.tiles[fatal_error])
+              << " ok: " << sum.tiles[ok]
+              << " warnings: " << sum.tiles[warning]
+              << " errors: " << sum.tiles[error]
+              << " fatal: " << sum.tiles[fatal_error] << '\n';
+    for (const auto& c : sum.classes) {
+        std::cout << "  " << c.second << ' ' << c.first << '\n';
+    }
+}
+
+static void print_summary_json(const summary& sum) {
+    std::cout << "{\n  \"tiles\": " << (sum.tiles[ok] + sum.tiles[warning] + sum.tiles[error] + sum.tiles[fatal_error]);
+    for (int level = ok; level <= fatal_error; ++level) {
+        std::cout << ",\n  \"" << level_name(level) << "\": " << sum.tiles[static_cast<std::size_t>(level)];
+    }
+    std::cout << ",\n  \"result\": \"" << level_name(sum.return_code) << '"';
+
+    std::cout << ",\n  \"classes\": {";
+    const char* sep = "\n";
+    for (const auto& c : sum.classes) {
+        std::cout << sep << "    " << json_string(c.first) << ": " << c.second;
+        sep = ",\n";
+    }
+    std::cout << (sum.classes.empty() ? "}" : "\n  }");
+
+    std::cout << ",\n  \"failed\": [";
+    sep = "\n";
+    for (const auto& f : sum.failed) {
+        std::cout << sep << "    {\"file\": " << json_string(f.first) << ", \"result\": \"" << level_name(f.second) << "\"}";
+        sep = ",\n";
+    }
+    std::cout << (sum.failed.empty() ? "]" : "\n  ]") << "\n}\n";
+}
+
+static void read_file_list(const std::string& filename, std::vector<std::string>& names) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (filename != "-") {
+        file.open(filename);
+        if (!file) {
+            throw std::runtime_error{std::string{"Can not open file '"} + filename + "'"};
+        }
+        in = &file;
+    }
+
+    std::string line;
+    while (std::getline(*in, line)) {
+        if (!line.empty()) {
+            names.push_back(line);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> names;
+    std::string file_list;
+    unsigned int num_threads = default_num_threads();
+    bool stop_at_error = false;
+    bool json = false;
+    bool quiet = false;
+    bool help = false;
+
+    const auto cli
+        = clara::Opt(file_list, "FILE")
+            ["-f"]["--files-from"]
+            ("read names of tiles to check from FILE (one per line, '-' for STDIN)")
+        | clara::Opt(num_threads, "N")
+            ["-j"]["--threads"]
+            ("number of threads (default: number of cores)")
+        | clara::Opt(stop_at_error)
+            ["-e"]["--first-error"]
+            ("stop checking a tile at its first error")
+        | clara::Opt(json)
+            ["-J"]["--json"]
+            ("print summary as JSON")
+        | clara::Opt(quiet)
+            ["-q"]["--quiet"]
+            ("don't print warnings and errors for each tile")
+        | clara::Help(help)
+        | clara::Arg(names, "TILE|DIR...")
+            ("vector tiles or directories with vector tiles");
+
+    const auto result = cli.parse(clara::Args(argc, argv));
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << '\n';
+        return 1;
+    }
+
+    if (help) {
+        std::cout << cli
+                  << "\nCheck vector tiles for validity.\n"
+                  << "Exit code is 0 if all tiles are okay, 1 if there were warnings,\n"
+                  << "2 if there were errors, and 3 if there were fatal errors.\n";
+        return 0;
+    }
+
+    std::vector<std::string> filenames;
+    try {
+        if (!file_list.empty()) {
+            read_file_list(file_list, names);
         }
-        std::cerr << ": " << e.what() << '\n';
-        result.has_fatal_error();
+        filenames = find_files(names);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    if (filenames.empty()) {
+        std::cerr << "Error in command line: Missing file name of vector tile to read\n";
+        return 1;
+    }
+
+    const bool batch = filenames.size() > 1 || !file_list.empty() || json;
+
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    std::vector<summary> summaries(num_threads);
+    std::mutex output_mutex;
+
+    run_in_parallel(filenames.size(), num_threads, [&](std::size_t n, unsigned int thread_num) {
+        const auto& filename = filenames[n];
+        check_result res{stop_at_error};
+        try {
+            const mapped_file file{filename};
+            check_tile(vtzero::data_view{file.data(), file.size()}, res);
+        } catch (const std::exception& e) {
+            res.add_fatal_error("", e.what());
+        }
+
+        if (!quiet && !res.messages().empty()) {
+            std::lock_guard<std::mutex> lock{output_mutex};
+            for (const auto& message : res.messages()) {
+                if (batch) {
+                    std::cerr << filename << ": ";
+                }
+                std::cerr << message << '\n';
+            }
+        }
+
+        summaries[thread_num].add(filename, res);
+    });
+
+    summary sum;
+    for (const auto& s : summaries) {
+        for (std::size_t i = 0; i < sum.tiles.size(); ++i) {
+            sum.tiles[i] += s.tiles[i];
+        }
+        for (const auto& c : s.classes) {
+            sum.classes[c.first] += c.second;
+        }
+        sum.failed.insert(sum.failed.end(), s.failed.begin(), s.failed.end());
+        sum.return_code = std::max(sum.return_code, s.return_code);
+    }
+    std::sort(sum.failed.begin(), sum.failed.end());
+
+    if (json) {
+        print_summary_json(sum);
+    } else if (batch) {
+        print_summary(sum);
     }
 
-    return result.return_code();
+    return sum.return_code;
 }
 
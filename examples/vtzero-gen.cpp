@@ -0,0 +1,137 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-gen - Generate a synthetic vector tile
+
+  The tile is described by a few parameters (number of layers, features,
+  vertices, keys and values, ...). The same parameters always generate the
+  same tile. Use this to create tiles for benchmarks which show how vtzero
+  scales along those axes.
+
+*****************************************************************************/
+
+#include "tile_generator.hpp"
+#include "utils.hpp"
+
+#include <clara.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static bool parse_mix(const std::string& mix, generator_config& config) {
+    char* end = nullptr;
+    const char* str = mix.c_str();
+
+    const auto points = std::strtoul(str, &end, 10);
+    if (*end != ',') {
+        return false;
+    }
+    const auto linestrings = std::strtoul(end + 1, &end, 10);
+    if (*end != ',') {
+        return false;
+    }
+    const auto polygons = std::strtoul(end + 1, &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+
+    config.points_weight = static_cast<uint32_t>(points);
+    config.linestrings_weight = static_cast<uint32_t>(linestrings);
+    config.polygons_weight = static_cast<uint32_t>(polygons);
+    return true;
+}
+
+static bool parse_ids(const std::string& ids, generator_config& config) {
+    if (ids == "none") {
+        config.ids = id_distribution::none;
+    } else if (ids == "sequential") {
+        config.ids = id_distribution::sequential;
+    } else if (ids == "random") {
+        config.ids = id_distribution::random;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    generator_config config;
+    std::string output_file{"synthetic.mvt"};
+    std::string mix{"1,1,1"};
+    std::string ids{"sequential"};
+    bool help = false;
+
+    const auto cli
+        = clara::Opt(output_file, "FILE")
+            ["-o"]["--output"]
+            ("write output to FILE (default: synthetic.mvt)")
+        | clara::Opt(config.seed, "SEED")
+            ["-s"]["--seed"]
+            ("seed for random number generator (default: 1)")
+        | clara::Opt(config.layers, "N")
+            ["-l"]["--layers"]
+            ("number of layers (default: 1)")
+        | clara::Opt(config.features, "N")
+            ["-f"]["--features"]
+            ("number of features per layer (default: 100)")
+        | clara::Opt(mix, "P,L,A")
+            ["-m"]["--mix"]
+            ("relative weights of points, linestrings, polygons (default: 1,1,1)")
+        | clara::Opt(config.vertices, "N")
+            ["-v"]["--vertices"]
+            ("vertices per linestring or polygon (default: 10)")
+        | clara::Opt(config.properties, "N")
+            ["-p"]["--properties"]
+            ("properties per feature (default: 5)")
+        | clara::Opt(config.keys, "N")
+            ["-k"]["--keys"]
+            ("number of different keys per layer (default: 10)")
+        | clara::Opt(config.values, "N")
+            ["-V"]["--values"]
+            ("number of different values per layer (default: 100)")
+        | clara::Opt(ids, "none|sequential|random")
+            ["-i"]["--ids"]
+            ("how feature IDs are assigned (default: sequential)")
+        | clara::Opt(config.extent, "N")
+            ["-e"]["--extent"]
+            ("extent of layers (default: 4096)")
+        | clara::Help(help);
+
+    const auto result = cli.parse(clara::Args(argc, argv));
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << '\n';
+        return 1;
+    }
+
+    if (help) {
+        std::cout << cli
+                  << "\nGenerate a synthetic vector tile.\n";
+        return 0;
+    }
+
+    if (!parse_mix(mix, config)) {
+        std::cerr << "Error in command line: Mix must be three numbers separated by commas\n";
+        return 1;
+    }
+
+    if (!parse_ids(ids, config)) {
+        std::cerr << "Error in command line: IDs must be 'none', 'sequential', or 'random'\n";
+        return 1;
+    }
+
+    try {
+        const auto data = generate_tile(config);
+        write_data_to_file(data, output_file);
+        std::cout << "Wrote " << data.size() << " bytes to '" << output_file << "'\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,165 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-geojson - Convert vector tile to GeoJSON
+
+  Writes all features of a tile (or of one layer) as a GeoJSON
+  FeatureCollection. If the tile address is given, coordinates are
+  converted to WGS84, otherwise tile coordinates are written. The output
+  is collected in a buffer which is written out whenever it gets large.
+
+*****************************************************************************/
+
+#include "utils.hpp"
+
+#include <vtzero/geojson.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <clara.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Size of the output buffer which triggers writing it out.
+static constexpr const std::size_t flush_size = 1024 * 1024;
+
+static bool parse_tile_address(const std::string& str, uint32_t& zoom, uint32_t& x, uint32_t& y) {
+    unsigned long long z = 0; // NOLINT(google-runtime-int)
+    unsigned long long tx = 0; // NOLINT(google-runtime-int)
+    unsigned long long ty = 0; // NOLINT(google-runtime-int)
+    char rest = '\0';
+    if (std::sscanf(str.c_str(), "%llu/%llu/%llu%c", &z, &tx, &ty, &rest) != 3) { // NOLINT(cppcoreguidelines-pro-type-vararg)
+        return false;
+    }
+    if (z > 32 || (tx >> z) != 0 || (ty >> z) != 0) {
+        return false;
+    }
+    zoom = static_cast<uint32_t>(z);
+    x = static_cast<uint32_t>(tx);
+    y = static_cast<uint32_t>(ty);
+    return true;
+}
+
+static void flush(std::string& buffer, std::FILE* out) {
+    if (std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+        throw std::runtime_error{"Error writing output"};
+    }
+    buffer.clear();
+}
+
+int main(int argc, char* argv[]) {
+    std::string filename;
+    std::string layer_num_or_name;
+    std::string tile_address;
+    std::string output_file;
+    int precision = -2;
+    bool help = false;
+
+    const auto cli
+        = clara::Opt(tile_address, "Z/X/Y")
+            ["-t"]["--tile"]
+            ("tile address, write WGS84 coordinates")
+        | clara::Opt(precision, "N")
+            ["-p"]["--precision"]
+            ("decimals for WGS84 coordinates (default: depends on zoom, use --precision=-1 for full)")
+        | clara::Opt(output_file, "FILE")
+            ["-o"]["--output"]
+            ("write output to FILE (default: STDOUT)")
+        | clara::Help(help)
+        | clara::Arg(filename, "FILENAME").required()
+            ("vector tile")
+        | clara::Arg(layer_num_or_name, "LAYER-NUM|LAYER-NAME")
+            ("only convert this layer");
+
+    const auto result = cli.parse(clara::Args(argc, argv));
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << '\n';
+        return 1;
+    }
+
+    if (help) {
+        std::cout << cli
+                  << "\nConvert vector tile to GeoJSON.\n";
+        return 0;
+    }
+
+    if (filename.empty()) {
+        std::cerr << "Error in command line: Missing file name of vector tile to read\n";
+        return 1;
+    }
+
+    uint32_t zoom = 0;
+    uint32_t x = 0;
+    uint32_t y = 0;
+    if (!tile_address.empty() && !parse_tile_address(tile_address, zoom, x, y)) {
+        std::cerr << "Error in command line: Invalid tile address '" << tile_address << "'\n";
+        return 1;
+    }
+
+    if (precision < -2 || precision > 15) {
+        std::cerr << "Error in command line: Precision must be between -1 and 15\n";
+        return 1;
+    }
+
+    std::FILE* out = stdout;
+    if (!output_file.empty()) {
+        out = std::fopen(output_file.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Can not open file '" << output_file << "'\n";
+            return 1;
+        }
+    }
+
+    try {
+        const auto data = read_file(filename);
+        vtzero::vector_tile tile{data};
+
+        std::string buffer;
+        buffer.reserve(flush_size + flush_size / 4);
+
+        vtzero::geojson_writer writer{buffer};
+        if (!tile_address.empty()) {
+            writer.set_tile(zoom, x, y);
+        }
+        writer.set_coordinate_precision(precision);
+
+        writer.begin_feature_collection();
+        auto convert_layer = [&](vtzero::layer& layer) {
+            while (const auto feature = layer.next_feature()) {
+                writer.add_feature(layer, feature);
+                if (buffer.size() >= flush_size) {
+                    flush(buffer, out);
+                }
+            }
+        };
+
+        if (layer_num_or_name.empty()) {
+            while (auto layer = tile.next_layer()) {
+                convert_layer(layer);
+            }
+        } else {
+            auto layer = get_layer(tile, layer_num_or_name);
+            convert_layer(layer);
+        }
+        writer.end_feature_collection();
+
+        flush(buffer, out);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    if (out != stdout && std::fclose(out) != 0) {
+        std::cerr << "Error writing output\n";
+        return 1;
+    }
+
+    return 0;
+}
+
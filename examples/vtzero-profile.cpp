@@ -0,0 +1,516 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-profile - Show where the bytes in vector tiles go
+
+  Attributes every byte of the tiles to one of the parts of the encoding
+  (layer header, key table, value table by value type, feature ids, tags,
+  geometry commands and geometry parameters, and the framing of the
+  feature messages) and sums them up per layer name over all tiles. It
+  also reports how well the tags and geometries are encoded, which values
+  in the value tables could be stored in a smaller type, and the largest
+  features.
+
+  Directories given on the command line are read recursively and the
+  tiles are processed in parallel.
+
+*****************************************************************************/
+
+#include "parallel.hpp"
+#include "utils.hpp"
+
+#include <vtzero/vector_tile.hpp>
+
+#include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
+
+#include <clara.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    enum category : std::size_t {
+        header,
+        keys,
+        values,
+        framing,
+        ids,
+        tags,
+        geometry_commands,
+        geometry_parameters,
+        num_categories
+    };
+
+    const std::array<const char*, num_categories> category_names = {{
+        "header", "keys", "values", "framing", "ids", "tags", "g-cmds", "g-params"
+    }};
+
+    const std::array<const char*, 8> value_type_names = {{
+        "", "string", "float", "double", "int", "uint", "sint", "bool"
+    }};
+
+    struct layer_profile {
+
+        uint64_t tiles = 0;
+        uint64_t features = 0;
+        std::array<uint64_t, num_categories> bytes{};
+        std::array<uint64_t, 8> value_bytes{};
+        uint64_t tag_varints = 0;
+        uint64_t multi_byte_tag_varints = 0;
+        uint64_t vertices = 0;
+        uint64_t narrow_to_float = 0;
+        uint64_t narrow_to_int = 0;
+        uint64_t narrow_saved_bytes = 0;
+
+        uint64_t total() const noexcept {
+            uint64_t sum = 0;
+            for (const auto b : bytes) {
+                sum += b;
+            }
+            return sum;
+        }
+
+        void add(const layer_profile& other) noexcept {
+            tiles += other.tiles;
+            features += other.features;
+            for (std::size_t i = 0; i < bytes.size(); ++i) {
+                bytes[i] += other.bytes[i];
+            }
+            for (std::size_t i = 0; i < value_bytes.size(); ++i) {
+                value_bytes[i] += other.value_bytes[i];
+            }
+            tag_varints += other.tag_varints;
+            multi_byte_tag_varints += other.multi_byte_tag_varints;
+            vertices += other.vertices;
+            narrow_to_float += other.narrow_to_float;
+            narrow_to_int += other.narrow_to_int;
+            narrow_saved_bytes += other.narrow_saved_bytes;
+        }
+
+    }; // struct layer_profile
+
+    struct feature_size {
+        std::size_t bytes;
+        std::string layer;
+        std::string id;
+        std::string filename;
+    };
+
+    bool operator<(const feature_size& lhs, const feature_size& rhs) noexcept {
+        return lhs.bytes > rhs.bytes;
+    }
+
+    // The results collected by one thread.
+    struct profile {
+
+        std::map<std::string, layer_profile> layers;
+        std::vector<feature_size> largest_features; // heap with smallest on top
+        std::vector<std::string> errors;
+        uint64_t tiles = 0;
+        uint64_t tile_bytes = 0;
+        uint64_t other_bytes = 0; // tile level fields other than layers
+        std::size_t top_n = 0;
+
+        void add_feature_size(feature_size&& fs) {
+            if (largest_features.size() < top_n) {
+                largest_features.push_back(std::move(fs));
+                std::push_heap(largest_features.begin(), largest_features.end());
+            } else if (top_n > 0 && fs.bytes > largest_features.front().bytes) {
+                std::pop_heap(largest_features.begin(), largest_features.end());
+                largest_features.back() = std::move(fs);
+                std::push_heap(largest_features.begin(), largest_features.end());
+            }
+        }
+
+        void add(profile& other) {
+            for (const auto& layer : other.layers) {
+                layers[layer.first].add(layer.second);
+            }
+            for (auto& fs : other.largest_features) {
+                add_feature_size(std::move(fs));
+            }
+            errors.insert(errors.end(), other.errors.begin(), other.errors.end());
+            tiles += other.tiles;
+            tile_bytes += other.tile_bytes;
+            other_bytes += other.other_bytes;
+        }
+
+    }; // struct profile
+
+    std::size_t varint_length(const uint64_t value) noexcept {
+        return static_cast<std::size_t>(protozero::length_of_varint(value));
+    }
+
+    // Size of a value table entry with a value encoded as varint.
+    std::size_t varint_value_size(const uint64_t value) noexcept {
+        const auto message_size = 1 + varint_length(value);
+        return 1 + varint_length(message_size) + message_size;
+    }
+
+    bool is_integral(const double value) noexcept {
+        return std::isfinite(value) &&
+               std::trunc(value) == value &&
+               value >= static_cast<double>(std::numeric_limits<int64_t>::min()) &&
+               value < static_cast<double>(std::numeric_limits<int64_t>::max());
+    }
+
+    // Check whether a float or double value could be stored in a smaller
+    // type and how many bytes that would save.
+    void check_narrowing(const vtzero::property_value value, const std::size_t field_bytes, layer_profile& lp) {
+        double d = 0.0;
+        if (value.type() == vtzero::property_value_type::double_value) {
+            d = value.double_value();
+        } else if (value.type() == vtzero::property_value_type::float_value) {
+            d = static_cast<double>(value.float_value());
+        } else {
+            return;
+        }
+
+        if (is_integral(d)) {
+            const auto i = static_cast<int64_t>(d);
+            const auto size = i < 0 ? varint_value_size(protozero::encode_zigzag64(i))
+                                    : varint_value_size(static_cast<uint64_t>(i));
+            if (size < field_bytes) {
+                ++lp.narrow_to_int;
+                lp.narrow_saved_bytes += field_bytes - size;
+            }
+            return;
+        }
+
+        if (value.type() == vtzero::property_value_type::double_value &&
+            std::isfinite(d) &&
+            static_cast<double>(static_cast<float>(d)) == d) {
+            ++lp.narrow_to_float;
+            lp.narrow_saved_bytes += 4;
+        }
+    }
+
+    void profile_tags(const vtzero::data_view data, layer_profile& lp) {
+        const char* it = data.data();
+        const char* const end = data.data() + data.size();
+        while (it != end) {
+            const char* start = it;
+            protozero::decode_varint(&it, end);
+            ++lp.tag_varints;
+            if (it - start > 1) {
+                ++lp.multi_byte_tag_varints;
+            }
+        }
+        lp.bytes[tags] += data.size();
+    }
+
+    void profile_geometry(const vtzero::data_view data, layer_profile& lp) {
+        const char* it = data.data();
+        const char* const end = data.data() + data.size();
+        while (it != end) {
+            const char* start = it;
+            const auto command = protozero::decode_varint(&it, end);
+            lp.bytes[geometry_commands] += static_cast<std::size_t>(it - start);
+
+            const auto id = command & 0x7u;
+            if (id != 1 && id != 2) { // not MoveTo or LineTo
+                continue;
+            }
+
+            const auto count = command >> 3u;
+            start = it;
+            for (uint64_t n = 0; n < count * 2 && it != end; ++n) {
+                protozero::decode_varint(&it, end);
+            }
+            lp.bytes[geometry_parameters] += static_cast<std::size_t>(it - start);
+            lp.vertices += count;
+        }
+    }
+
+    void profile_feature(const vtzero::data_view data, layer_profile& lp, std::string& id) {
+        protozero::pbf_message<vtzero::detail::pbf_feature> reader{data};
+        std::size_t remaining = reader.length();
+        while (reader.next()) {
+            switch (reader.tag_and_type()) {
+                case protozero::tag_and_type(vtzero::detail::pbf_feature::id, protozero::pbf_wire_type::varint):
+                    id = std::to_string(reader.get_uint64());
+                    lp.bytes[ids] += remaining - reader.length();
+                    break;
+                case protozero::tag_and_type(vtzero::detail::pbf_feature::tags, protozero::pbf_wire_type::length_delimited): {
+                        const auto view = reader.get_view();
+                        lp.bytes[framing] += remaining - reader.length() - view.size();
+                        profile_tags(view, lp);
+                    }
+                    break;
+                case protozero::tag_and_type(vtzero::detail::pbf_feature::geometry, protozero::pbf_wire_type::length_delimited): {
+                        const auto view = reader.get_view();
+                        lp.bytes[framing] += remaining - reader.length() - view.size();
+                        profile_geometry(view, lp);
+                    }
+                    break;
+                default:
+                    reader.skip();
+                    lp.bytes[framing] += remaining - reader.length();
+                    break;
+            }
+            remaining = reader.length();
+        }
+    }
+
+    void profile_layer(const vtzero::data_view data, const std::size_t field_framing, const std::string& filename, profile& p) {
+        const vtzero::layer layer{data};
+        const std::string name{layer.name()};
+        auto& lp = p.layers[name];
+        ++lp.tiles;
+        lp.bytes[header] += field_framing;
+
+        protozero::pbf_message<vtzero::detail::pbf_layer> reader{data};
+        std::size_t remaining = reader.length();
+        while (reader.next()) {
+            switch (reader.tag_and_type()) {
+                case protozero::tag_and_type(vtzero::detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited): {
+                        const auto view = reader.get_view();
+                        lp.bytes[framing] += remaining - reader.length() - view.size();
+                        std::string id{"-"};
+                        profile_feature(view, lp, id);
+                        ++lp.features;
+                        p.add_feature_size({remaining - reader.length(), name, id, filename});
+                    }
+                    break;
+                case protozero::tag_and_type(vtzero::detail::pbf_layer::keys, protozero::pbf_wire_type::length_delimited):
+                    reader.skip();
+                    lp.bytes[keys] += remaining - reader.length();
+                    break;
+                case protozero::tag_and_type(vtzero::detail::pbf_layer::values, protozero::pbf_wire_type::length_delimited): {
+                        const vtzero::property_value value{reader.get_view()};
+                        const auto field_bytes = remaining - reader.length();
+                        lp.bytes[values] += field_bytes;
+                        lp.value_bytes[static_cast<std::size_t>(value.type())] += field_bytes;
+                        check_narrowing(value, field_bytes, lp);
+                    }
+                    break;
+                default:
+                    reader.skip();
+                    lp.bytes[header] += remaining - reader.length();
+                    break;
+            }
+            remaining = reader.length();
+        }
+    }
+
+    void profile_tile(const std::string& filename, profile& p) {
+        const auto data = read_file(filename);
+        ++p.tiles;
+        p.tile_bytes += data.size();
+
+        protozero::pbf_message<vtzero::detail::pbf_tile> reader{data};
+        std::size_t remaining = reader.length();
+        while (reader.next()) {
+            if (reader.tag_and_type() == protozero::tag_and_type(vtzero::detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited)) {
+                const auto view = reader.get_view();
+                profile_layer(view, remaining - reader.length() - view.size(), filename, p);
+            } else {
+                reader.skip();
+                p.other_bytes += remaining - reader.length();
+            }
+            remaining = reader.length();
+        }
+    }
+
+    double percent(const uint64_t part, const uint64_t total) noexcept {
+        return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+    }
+
+    void print_bytes(const std::map<std::string, layer_profile>& layers, const layer_profile& sum, const int width) {
+        std::cout << std::left << std::setw(width) << "layer" << std::right
+                  << std::setw(7) << "tiles"
+                  << std::setw(10) << "features"
+                  << std::setw(12) << "bytes";
+        for (const auto name : category_names) {
+            std::cout << std::setw(11) << name;
+        }
+        std::cout << '\n';
+
+        auto print_line = [&](const std::string& name, const layer_profile& lp) {
+            std::cout << std::left << std::setw(width) << name << std::right
+                      << std::setw(7) << lp.tiles
+                      << std::setw(10) << lp.features
+                      << std::setw(12) << lp.total();
+            for (const auto b : lp.bytes) {
+                std::cout << std::setw(11) << b;
+            }
+            std::cout << '\n';
+        };
+
+        for (const auto& layer : layers) {
+            print_line(layer.first, layer.second);
+        }
+        print_line("TOTAL", sum);
+
+        std::cout << std::left << std::setw(width) << "%" << std::right
+                  << std::setw(29) << ""
+                  << std::fixed << std::setprecision(1);
+        for (const auto b : sum.bytes) {
+            std::cout << std::setw(11) << percent(b, sum.total());
+        }
+        std::cout << "\n\n";
+    }
+
+    void print_value_bytes(const std::map<std::string, layer_profile>& layers, const layer_profile& sum, const int width) {
+        std::cout << std::left << std::setw(width) << "value bytes by type" << std::right;
+        for (std::size_t i = 1; i < value_type_names.size(); ++i) {
+            std::cout << std::setw(11) << value_type_names[i];
+        }
+        std::cout << '\n';
+
+        auto print_line = [&](const std::string& name, const layer_profile& lp) {
+            std::cout << std::left << std::setw(width) << name << std::right;
+            for (std::size_t i = 1; i < lp.value_bytes.size(); ++i) {
+                std::cout << std::setw(11) << lp.value_bytes[i];
+            }
+            std::cout << '\n';
+        };
+
+        for (const auto& layer : layers) {
+            print_line(layer.first, layer.second);
+        }
+        print_line("TOTAL", sum);
+        std::cout << '\n';
+    }
+
+    void print_efficiency(const std::map<std::string, layer_profile>& layers, const layer_profile& sum, const int width) {
+        std::cout << std::left << std::setw(width) << "encoding" << std::right
+                  << std::setw(12) << "tag-varints"
+                  << std::setw(12) << "multi-byte%"
+                  << std::setw(12) << "vertices"
+                  << std::setw(12) << "bytes/vert"
+                  << std::setw(12) << "to-float"
+                  << std::setw(12) << "to-int"
+                  << std::setw(12) << "saved-bytes" << '\n';
+
+        auto print_line = [&](const std::string& name, const layer_profile& lp) {
+            const auto geometry_bytes = lp.bytes[geometry_commands] + lp.bytes[geometry_parameters];
+            std::cout << std::left << std::setw(width) << name << std::right
+                      << std::setw(12) << lp.tag_varints
+                      << std::setw(12) << percent(lp.multi_byte_tag_varints, lp.tag_varints)
+                      << std::setw(12) << lp.vertices
+                      << std::setw(12) << (lp.vertices == 0 ? 0.0 : static_cast<double>(geometry_bytes) / static_cast<double>(lp.vertices))
+                      << std::setw(12) << lp.narrow_to_float
+                      << std::setw(12) << lp.narrow_to_int
+                      << std::setw(12) << lp.narrow_saved_bytes << '\n';
+        };
+
+        for (const auto& layer : layers) {
+            print_line(layer.first, layer.second);
+        }
+        print_line("TOTAL", sum);
+        std::cout << '\n';
+    }
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> names;
+    unsigned int num_threads = default_num_threads();
+    std::size_t top_n = 10;
+    bool help = false;
+
+    const auto cli
+        = clara::Opt(num_threads, "N")
+            ["-j"]["--threads"]
+            ("number of threads (default: number of cores)")
+        | clara::Opt(top_n, "N")
+            ["-t"]["--top"]
+            ("show the N largest features (default: 10)")
+        | clara::Help(help)
+        | clara::Arg(names, "TILE|DIR...")
+            ("vector tiles or directories with vector tiles");
+
+    const auto result = cli.parse(clara::Args(argc, argv));
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << '\n';
+        return 1;
+    }
+
+    if (help) {
+        std::cout << cli
+                  << "\nShow where the bytes in the specified vector tiles go.\n";
+        return 0;
+    }
+
+    if (names.empty()) {
+        std::cerr << "Error in command line: Missing file name of vector tile to read\n";
+        return 1;
+    }
+
+    std::vector<std::string> filenames;
+    try {
+        filenames = find_files(names);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    std::vector<profile> profiles(num_threads);
+    for (auto& p : profiles) {
+        p.top_n = top_n;
+    }
+
+    run_in_parallel(filenames.size(), num_threads, [&](std::size_t n, unsigned int thread_num) {
+        try {
+            profile_tile(filenames[n], profiles[thread_num]);
+        } catch (const std::exception& e) {
+            profiles[thread_num].errors.push_back(filenames[n] + ": " + e.what());
+        }
+    });
+
+    profile p;
+    p.top_n = top_n;
+    for (auto& thread_profile : profiles) {
+        p.add(thread_profile);
+    }
+
+    layer_profile sum;
+    int width = 20;
+    for (const auto& layer : p.layers) {
+        sum.add(layer.second);
+        width = std::max(width, static_cast<int>(layer.first.size()) + 1);
+    }
+    sum.tiles = p.tiles;
+
+    std::cout << "tiles: " << p.tiles
+              << " bytes: " << p.tile_bytes
+              << " (other tile fields: " << p.other_bytes << ")\n\n";
+
+    print_bytes(p.layers, sum, width);
+    print_value_bytes(p.layers, sum, width);
+    print_efficiency(p.layers, sum, width);
+
+    std::sort_heap(p.largest_features.begin(), p.largest_features.end());
+    if (!p.largest_features.empty()) {
+        std::cout << "largest features:\n";
+        for (const auto& fs : p.largest_features) {
+            std::cout << std::setw(10) << fs.bytes << ' ' << fs.layer << ' ' << fs.id << ' ' << fs.filename << '\n';
+        }
+    }
+
+    for (const auto& error : p.errors) {
+        std::cerr << "Error: " << error << '\n';
+    }
+
+    return p.errors.empty() ? 0 : 1;
+}
+
@@ -0,0 +1,175 @@
+#ifndef VTZERO_BUFFER_POOL_HPP
+#define VTZERO_BUFFER_POOL_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file buffer_pool.hpp
+ *
+ * @brief Contains the buffer_pool class.
+ */
+
+#include "table_index.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+        class layer_builder_impl;
+    } // namespace detail
+
+    /**
+     * A pool of buffers which can be used by tile builders. Without a pool
+     * each layer builder allocates new buffers for its data and key and
+     * value tables and frees them when the tile builder is destroyed. If
+     * many tiles are built one after the other, the tile builders can use
+     * a buffer pool instead: The layer builders take their buffers from the
+     * pool and give them back when the tile builder is destroyed. The
+     * same is done with the indexes layer builders use to find keys and
+     * values already in their tables. The buffers and indexes keep their
+     * memory, so after the first few tiles there are hardly any
+     * allocations any more.
+     *
+     * @code
+     * vtzero::buffer_pool pool;
+     * for (...) {
+     *     vtzero::tile_builder tbuilder{pool};
+     *     ...
+     *     tbuilder.serialize(output);
+     * } // all buffers are back in the pool here
+     * @endcode
+     *
+     * A buffer pool is not thread-safe. Use one pool per thread. The pool
+     * must outlive all tile builders using it.
+     */
+    class buffer_pool {
+
+        friend class detail::layer_builder_impl;
+
+        std::vector<std::string> m_buffers;
+
+        // The indexes of one layer builder each. There are three buffers
+        // per layer builder, so only a third as many of these are kept.
+        std::vector<detail::layer_indexes> m_indexes;
+
+        std::size_t m_max_buffers;
+
+        std::size_t m_max_buffer_size;
+
+        std::size_t max_indexes() const noexcept {
+            return (m_max_buffers + 2) / 3;
+        }
+
+        // Take the indexes from the pool (if there are any) and swap them
+        // into the specified indexes which must be empty.
+        void acquire(detail::layer_indexes& indexes) noexcept {
+            if (!m_indexes.empty()) {
+                std::swap(indexes, m_indexes.back());
+                m_indexes.pop_back();
+            }
+        }
+
+        // Give the specified indexes back to the pool. They are cleared,
+        // but their memory is kept in the pool.
+        void release(detail::layer_indexes& indexes) noexcept {
+            const auto capacity = indexes.capacity();
+            if (capacity == 0 || m_indexes.size() >= max_indexes() || capacity > m_max_buffer_size) {
+                return;
+            }
+            indexes.clear();
+            // can't throw, space was reserved in the constructor
+            m_indexes.emplace_back();
+            std::swap(m_indexes.back(), indexes);
+        }
+
+    public:
+
+        /**
+         * Construct buffer pool.
+         *
+         * @param max_buffers The maximum number of buffers kept in the pool.
+         *        The indexes of max_buffers / 3 (rounded up) layers are
+         *        kept in addition to that.
+         * @param max_buffer_size Buffers (and indexes) with a capacity
+         *        larger than this are freed instead of kept in the pool.
+         */
+        explicit buffer_pool(const std::size_t max_buffers = 64,
+                             const std::size_t max_buffer_size = 16 * 1024 * 1024) :
+            m_max_buffers(max_buffers),
+            m_max_buffer_size(max_buffer_size) {
+            m_buffers.reserve(max_buffers);
+            m_indexes.reserve(max_indexes());
+        }
+
+        /// The number of buffers (not counting the indexes) currently in the pool.
+        std::size_t size() const noexcept {
+            return m_buffers.size();
+        }
+
+        /**
+         * The overall capacity of all buffers and indexes currently in the
+         * pool in bytes.
+         */
+        std::size_t capacity() const noexcept {
+            std::size_t sum = 0;
+            for (const auto& buffer : m_buffers) {
+                sum += buffer.capacity();
+            }
+            for (const auto& indexes : m_indexes) {
+                sum += indexes.capacity();
+            }
+            return sum;
+        }
+
+        /// Free all buffers and indexes in the pool.
+        void clear() noexcept {
+            m_buffers.clear();
+            m_indexes.clear();
+        }
+
+        /**
+         * Take a buffer from the pool (if there is one) and swap it into
+         * the specified buffer which must be empty.
+         */
+        void acquire(std::string& buffer) noexcept {
+            if (!m_buffers.empty()) {
+                swap(buffer, m_buffers.back());
+                m_buffers.pop_back();
+            }
+        }
+
+        /**
+         * Give the specified buffer back to the pool. The content of the
+         * buffer is cleared, but its memory is kept in the pool. The buffer
+         * will be empty after this call.
+         */
+        void release(std::string& buffer) noexcept {
+            if (buffer.capacity() == 0) {
+                return;
+            }
+            if (m_buffers.size() < m_max_buffers && buffer.capacity() <= m_max_buffer_size) {
+                buffer.clear();
+                // can't throw, space was reserved in the constructor
+                m_buffers.emplace_back();
+                swap(m_buffers.back(), buffer);
+            } else {
+                std::string{}.swap(buffer);
+            }
+        }
+
+    }; // class buffer_pool
+
+} // namespace vtzero
+
+#endif // VTZERO_BUFFER_POOL_HPP
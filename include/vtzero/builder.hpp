@@ -17,13 +17,16 @@ documentation.
  */
 
 #include "builder_impl.hpp"
+#include "exception.hpp"
 #include "feature_builder_impl.hpp"
 #include "geometry.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 #include "vector_tile.hpp"
 
 #include <protozero/pbf_builder.hpp>
 
+#include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -55,6 +58,8 @@ namespace vtzero {
 
         std::vector<std::unique_ptr<detail::layer_builder_base>> m_layers;
 
+        buffer_pool* m_pool = nullptr;
+
         /**
          * Add a new layer to the vector tile based on an existing layer. The
          * new layer will have the same name, version, and extent as the
@@ -63,7 +68,7 @@ namespace vtzero {
          * existing layer.
          */
         detail::layer_builder_impl* add_layer(const layer& layer) {
-            const auto ptr = new detail::layer_builder_impl{layer.name(), layer.version(), layer.extent()};
+            const auto ptr = new detail::layer_builder_impl{layer.name(), layer.version(), layer.extent(), m_pool};
             m_layers.emplace_back(ptr);
             return ptr;
         }
@@ -82,7 +87,7 @@ namespace vtzero {
          */
         template <typename TString>
         detail::layer_builder_impl* add_layer(TString&& name, uint32_t version, uint32_t extent) {
-            const auto ptr = new detail::layer_builder_impl{std::forward<TString>(name), version, extent};
+            const auto ptr = new detail::layer_builder_impl{std::forward<TString>(name), version, extent, m_pool};
             m_layers.emplace_back(ptr);
             return ptr;
         }
@@ -92,6 +97,17 @@ namespace vtzero {
         /// Constructor
         tile_builder() = default;
 
+        /**
+         * Construct a tile builder using buffers from the specified pool
+         * for all its layers. The buffers are given back to the pool when
+         * the tile builder is destroyed.
+         *
+         * @param pool The buffer pool. It must outlive the tile builder.
+         */
+        explicit tile_builder(buffer_pool& pool) noexcept :
+            m_pool(&pool) {
+        }
+
         /// Destructor
         ~tile_builder() noexcept = default;
 
@@ -131,24 +147,16 @@ namespace vtzero {
         }
 
         /**
-         * Serialize the data accumulated in this builder into a vector tile.
-         * The data will be appended to the specified buffer. The buffer
-         * doesn't have to be empty.
+         * Add a layer fragment to the vector tile. The fragment data is not
+         * copied until the serialize() method is called, the tile builder
+         * keeps a reference to the data, so the fragment itself doesn't need
+         * to be kept around.
          *
-         * @param buffer Buffer to append the encoded vector tile to.
+         * @param fragment The layer fragment.
+         * @pre @code fragment.valid() @endcode
          */
-        void serialize(std::string& buffer) const {
-            std::size_t estimated_size = 0;
-            for (const auto& layer : m_layers) {
-                estimated_size += layer->estimated_size();
-            }
-
-            buffer.reserve(buffer.size() + estimated_size);
-
-            protozero::pbf_builder<detail::pbf_tile> pbf_tile_builder{buffer};
-            for (const auto& layer : m_layers) {
-                layer->build(pbf_tile_builder);
-            }
+        void add_existing_layer(const layer_fragment& fragment) {
+            m_layers.emplace_back(new detail::layer_builder_fragment{fragment});
         }
 
         /**
@@ -156,7 +164,7 @@ namespace vtzero {
          * and return it.
          *
          * If you want to use an existing buffer instead, use the serialize()
-         * method taking a std::string& as parameter.
+         * method taking a buffer as parameter.
          *
          * @returns std::string Buffer with encoded vector_tile data.
          */
@@ -166,8 +174,84 @@ namespace vtzero {
             return data;
         }
 
+        /**
+         * The exact size of the encoded vector tile if serialize() is
+         * called now.
+         */
+        std::size_t serialized_size() const noexcept {
+            std::size_t size = 0;
+            for (const auto& layer : m_layers) {
+                size += layer->encoded_size();
+            }
+            return size;
+        }
+
+        /**
+         * Serialize the data accumulated in this builder into a vector tile
+         * written into a fixed memory region, for instance a slot in a
+         * memory-mapped file or a network buffer. Use serialized_size() to
+         * find out how large the memory region has to be.
+         *
+         * @param data Pointer to the memory region.
+         * @param size Size of the memory region.
+         * @returns The number of bytes written (always serialized_size()).
+         * @throws buffer_size_exception if size < serialized_size(). Nothing
+         *         is written to the memory region in that case.
+         */
+        std::size_t serialize(char* data, const std::size_t size) const {
+            const auto needed = serialized_size();
+            if (needed > size) {
+                throw buffer_size_exception{needed, size};
+            }
+
+            char* out = data;
+            for (const auto& layer : m_layers) {
+                out = layer->write(out);
+            }
+            vtzero_assert(static_cast<std::size_t>(out - data) == needed && "encoded_size() and write() disagree");
+            vtzero_stats_add(tiles_serialized, 1);
+            vtzero_stats_add(serialized_bytes, needed);
+
+            return needed;
+        }
+
+        /**
+         * Serialize the data accumulated in this builder into a vector tile.
+         * The data will be appended to the specified buffer. The buffer
+         * doesn't have to be empty.
+         *
+         * @tparam TBuffer Buffer type. Must have size(), resize(), and
+         *         operator[] like std::string or std::vector<char>.
+         * @param buffer Buffer to append the encoded vector tile to.
+         */
+        template <typename TBuffer>
+        void serialize(TBuffer& buffer) const {
+            const auto old_size = buffer.size();
+            const auto size = serialized_size();
+            buffer.resize(old_size + size);
+            serialize(size == 0 ? nullptr : &buffer[old_size], size);
+        }
+
+        /**
+         * Serialize the data accumulated in this builder into a vector_tile
+         * and return it.
+         *
+         * @tparam TBuffer Buffer type. Must be default constructible and
+         *         have size(), resize(), and operator[] like std::string
+         *         or std::vector<char>.
+         * @returns Buffer with encoded vector_tile data.
+         */
+        template <typename TBuffer>
+        TBuffer serialize() const {
+            TBuffer buffer;
+            serialize(buffer);
+            return buffer;
+        }
+
     }; // class tile_builder
 
+    class property_mapper;
+
     /**
      * The layer_builder is used to add a new layer to a vector tile that is
      * being built.
@@ -180,11 +264,16 @@ namespace vtzero {
         friend class point_feature_builder;
         friend class linestring_feature_builder;
         friend class polygon_feature_builder;
+        friend class tile_patcher;
 
         vtzero::detail::layer_builder_impl& get_layer_impl() noexcept {
             return *m_layer;
         }
 
+        explicit layer_builder(vtzero::detail::layer_builder_impl* layer) noexcept :
+            m_layer(layer) {
+        }
+
         template <typename T>
         using is_layer = std::is_same<typename std::remove_cv<typename std::remove_reference<T>::type>::type, layer>;
 
@@ -216,6 +305,37 @@ namespace vtzero {
             m_layer(tile.add_layer(std::forward<TString>(name), version, extent)) {
         }
 
+        /**
+         * Use a shared dictionary for the keys and values of this layer.
+         * From now on add_key() and add_value() will look up keys and values
+         * in the dictionary first and copy the pre-encoded entries from
+         * there. The dictionary must outlive the layer builder and must
+         * not be changed while it is used.
+         *
+         * @param dictionary The dictionary.
+         * @pre The key and value tables of the layer must be empty.
+         */
+        void use_dictionary(const shared_dictionary& dictionary) {
+            m_layer->use_dictionary(dictionary);
+        }
+
+        /**
+         * Set the strategy used by add_key() and add_value() to find keys
+         * and values already in the tables of this layer. The default is
+         * table_index_policy::automatic. Use table_index_policy::no_dedup
+         * if you know there are no duplicates or use an external index.
+         *
+         * @param policy The policy.
+         */
+        void set_table_index_policy(const table_index_policy policy) noexcept {
+            m_layer->set_table_index_policy(policy);
+        }
+
+        /// Get the current table index policy of this layer.
+        table_index_policy get_table_index_policy() const noexcept {
+            return m_layer->get_table_index_policy();
+        }
+
         /**
          * Add key to the keys table without checking for duplicates. This
          * function is usually used when an external index is used which takes
@@ -298,6 +418,70 @@ namespace vtzero {
          */
         void add_feature(const feature& feature);
 
+        /**
+         * Add a feature from an existing layer to the new layer using the
+         * specified property mapper. The feature will be copied completely
+         * over to the new layer including its geometry and all its
+         * properties. Unlike add_feature(const feature&) the keys and values
+         * are not looked up in the new layer for each property, instead the
+         * mapper remembers the index values it has already seen. So this is
+         * much faster when many features from the same layer are copied.
+         *
+         * You have to include property_mapper.hpp to use this function.
+         *
+         * @param feature The feature to copy.
+         * @param mapper The property mapper. It must have been created for
+         *        the layer the feature is from and this layer builder.
+         */
+        void add_feature(const feature& feature, property_mapper& mapper);
+
+        /**
+         * Remember the current state of the layer. Use rollback_to() to go
+         * back to this state later, removing all features and all keys and
+         * values added in the meantime. This is cheap, only a few sizes
+         * are recorded.
+         *
+         * @pre No feature builder must be active on this layer.
+         */
+        layer_savepoint savepoint() const noexcept {
+            return m_layer->savepoint();
+        }
+
+        /**
+         * Go back to the state of the layer when the savepoint was created.
+         * All features added since then are removed, keys and values added
+         * to the key and value tables since then are removed as well. The
+         * cost is proportional to the number of keys and values removed.
+         *
+         * Savepoints created after the specified one become invalid, the
+         * specified savepoint and earlier ones stay valid.
+         *
+         * @param sp Savepoint created by savepoint() on this layer.
+         * @pre No feature builder must be active on this layer.
+         */
+        void rollback_to(const layer_savepoint& sp) {
+            m_layer->rollback_to(sp);
+        }
+
+        /**
+         * Create a layer fragment from the current state of this layer. The
+         * fragment contains a copy of the layer data which can be added to
+         * any number of tiles using tile_builder::add_existing_layer().
+         *
+         * @code
+         * vtzero::tile_builder tmp;
+         * vtzero::layer_builder lbuilder{tmp, "water"};
+         * ... add features ...
+         * const auto water = lbuilder.fragment();
+         * @endcode
+         *
+         * @returns The new layer fragment.
+         * @pre No feature builder must be active on this layer.
+         */
+        layer_fragment fragment() const {
+            return m_layer->fragment();
+        }
+
     }; // class layer_builder
 
     /**
@@ -1249,6 +1433,7 @@ namespace vtzero {
             feature_builder.add_property(p);
             return true;
         });
+        feature_builder.commit();
     }
 
 } // namespace vtzero
@@ -16,20 +16,67 @@ documentation.
  * @brief Contains classes internal to the builder.
  */
 
+#include "buffer_pool.hpp"
 #include "encoded_property_value.hpp"
+#include "layer_fragment.hpp"
 #include "property_value.hpp"
+#include "shared_dictionary.hpp"
+#include "stats.hpp"
+#include "table_index.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_builder.hpp>
 #include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <string>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace vtzero {
 
+    namespace detail {
+        class layer_builder_impl;
+    } // namespace detail
+
+    /**
+     * The state of a layer_builder at some point in time. Returned from
+     * layer_builder::savepoint() and used with layer_builder::rollback_to().
+     */
+    class layer_savepoint {
+
+        friend class detail::layer_builder_impl;
+
+        const detail::layer_builder_impl* m_layer;
+        std::size_t m_data_size;
+        std::size_t m_keys_data_size;
+        std::size_t m_values_data_size;
+        std::size_t m_num_features;
+        uint32_t m_num_keys;
+        uint32_t m_num_values;
+
+        layer_savepoint(const detail::layer_builder_impl* layer,
+                        std::size_t data_size,
+                        std::size_t keys_data_size,
+                        std::size_t values_data_size,
+                        std::size_t num_features,
+                        uint32_t num_keys,
+                        uint32_t num_values) noexcept :
+            m_layer(layer),
+            m_data_size(data_size),
+            m_keys_data_size(keys_data_size),
+            m_values_data_size(values_data_size),
+            m_num_features(num_features),
+            m_num_keys(num_keys),
+            m_num_values(num_values) {
+        }
+
+    }; // class layer_savepoint
+
     namespace detail {
 
         class layer_builder_base {
@@ -46,9 +93,34 @@ namespace vtzero {
             layer_builder_base(layer_builder_base&&) noexcept = default;
             layer_builder_base& operator=(layer_builder_base&&) noexcept = default;
 
-            virtual std::size_t estimated_size() const = 0;
+            // The exact size of the encoded layer including the protobuf
+            // tag and length or 0 if this layer will not be written.
+            virtual std::size_t encoded_size() const noexcept = 0;
+
+            // Write the encoded layer including the protobuf tag and length
+            // to out which must have space for encoded_size() bytes. Returns
+            // the position after the layer.
+            virtual char* write(char* out) const noexcept = 0;
 
-            virtual void build(protozero::pbf_builder<detail::pbf_tile>& pbf_tile_builder) const = 0;
+        protected:
+
+            static std::size_t field_size(const std::size_t content_size) noexcept {
+                std::size_t varint_size = 1;
+                for (auto n = content_size; n >= 0x80u; n >>= 7u) {
+                    ++varint_size;
+                }
+                return 1 + varint_size + content_size;
+            }
+
+            static char* write_header(char* out, const std::size_t content_size) noexcept {
+                *out++ = static_cast<char>(protozero::tag_and_type(detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited));
+                return out + protozero::write_varint(out, content_size);
+            }
+
+            static char* write_data(char* out, const std::string& data) noexcept {
+                std::copy(data.begin(), data.end(), out);
+                return out + data.size();
+            }
 
         }; // class layer_builder_base
 
@@ -76,40 +148,20 @@ namespace vtzero {
             // The number of values in the values table
             uint32_t m_num_values = 0;
 
-            // Below this value, no index will be used to find entries in the
-            // key/value tables. This number is based on some initial
-            // benchmarking but probably needs some tuning.
-            // See also https://github.com/mapbox/vtzero/issues/30
-            static constexpr const uint32_t max_entries_flat = 20;
-
-            using map_type = std::unordered_map<std::string, index_value>;
-            map_type m_keys_index;
-            map_type m_values_index;
-
-            static index_value find_in_table(const data_view text, const std::string& data) {
-                uint32_t index = 0;
-                protozero::pbf_message<detail::pbf_layer> pbf_table{data};
-
-                while (pbf_table.next()) {
-                    const auto v = pbf_table.get_view();
-                    if (v == text) {
-                        return index_value{index};
-                    }
-                    ++index;
-                }
+            // The indexes of the key and value tables and the mappings
+            // from the shared dictionary
+            layer_indexes m_indexes;
 
-                return index_value{};
-            }
+            // The shared dictionary used by this layer (if any)
+            const shared_dictionary* m_dictionary = nullptr;
 
-            // Read the key or value table and populate an index from its
-            // entries. This is done once the table becomes too large to do
-            // linear search in it.
-            static void populate_index(const std::string& data, map_type& map) {
-                uint32_t index = 0;
-                protozero::pbf_message<detail::pbf_layer> pbf_table{data};
+            // The pool the buffers are taken from and given back to (if any)
+            buffer_pool* m_pool = nullptr;
 
-                while (pbf_table.next()) {
-                    map[pbf_table.get_string()] = index++;
+            static void remove_from_dictionary_map(const uint32_t num, std::vector<index_value>& map, std::vector<uint32_t>& used) noexcept {
+                while (!used.empty() && map[used.back()].value() >= num) {
+                    map[used.back()] = index_value{};
+                    used.pop_back();
                 }
             }
 
@@ -119,58 +171,56 @@ namespace vtzero {
             }
 
             index_value add_value(const data_view text) {
-                const auto index = find_in_values_table(text);
+                if (m_dictionary) {
+                    const auto didx = m_dictionary->find_value(text);
+                    if (didx.valid()) {
+                        vtzero_stats_add(dictionary_hits, 1);
+                        auto& idx = m_indexes.dictionary_values[didx.value()];
+                        if (!idx.valid()) {
+                            const auto field = m_dictionary->value_field(didx);
+                            m_values_data.append(field.data(), field.size());
+                            idx = m_num_values++;
+                            m_indexes.dictionary_values_used.push_back(didx.value());
+                        }
+                        return idx;
+                    }
+                }
+                const auto index = m_indexes.values.find(m_values_data, text);
                 if (index.valid()) {
+                    vtzero_stats_add(value_dedup_hits, 1);
                     return index;
                 }
+                vtzero_stats_add(value_dedup_misses, 1);
                 return add_value_without_dup_check(text);
             }
 
-            index_value find_in_keys_table(const data_view text) {
-                if (m_num_keys < max_entries_flat) {
-                    return find_in_table(text, m_keys_data);
-                }
-
-                if (m_keys_index.empty()) {
-                    populate_index(m_keys_data, m_keys_index);
-                }
-
-                auto& v = m_keys_index[std::string(text)];
-                if (!v.valid()) {
-                    v = add_key_without_dup_check(text);
-                }
-                return v;
-            }
-
-            index_value find_in_values_table(const data_view text) {
-                if (m_num_values < max_entries_flat) {
-                    return find_in_table(text, m_values_data);
-                }
-
-                if (m_values_index.empty()) {
-                    populate_index(m_values_data, m_values_index);
-                }
-
-                auto& v = m_values_index[std::string(text)];
-                if (!v.valid()) {
-                    v = add_value_without_dup_check(text);
-                }
-                return v;
-            }
-
         public:
 
             template <typename TString>
-            layer_builder_impl(TString&& name, uint32_t version, uint32_t extent) :
+            layer_builder_impl(TString&& name, uint32_t version, uint32_t extent, buffer_pool* pool = nullptr) :
                 m_pbf_message_layer(m_data),
                 m_pbf_message_keys(m_keys_data),
-                m_pbf_message_values(m_values_data) {
+                m_pbf_message_values(m_values_data),
+                m_pool(pool) {
+                if (m_pool) {
+                    m_pool->acquire(m_data);
+                    m_pool->acquire(m_keys_data);
+                    m_pool->acquire(m_values_data);
+                    m_pool->acquire(m_indexes);
+                }
                 m_pbf_message_layer.add_uint32(detail::pbf_layer::version, version);
                 m_pbf_message_layer.add_string(detail::pbf_layer::name, std::forward<TString>(name));
                 m_pbf_message_layer.add_uint32(detail::pbf_layer::extent, extent);
             }
 
-            ~layer_builder_impl() noexcept override = default;
+            ~layer_builder_impl() noexcept override {
+                if (m_pool) {
+                    m_pool->release(m_data);
+                    m_pool->release(m_keys_data);
+                    m_pool->release(m_values_data);
+                    m_pool->release(m_indexes);
+                }
+            }
 
             layer_builder_impl(const layer_builder_impl&) = delete;
             layer_builder_impl& operator=(const layer_builder_impl&) = delete;
@@ -184,10 +234,26 @@ namespace vtzero {
             }
 
             index_value add_key(const data_view text) {
-                const auto index = find_in_keys_table(text);
+                if (m_dictionary) {
+                    const auto didx = m_dictionary->find_key(text);
+                    if (didx.valid()) {
+                        vtzero_stats_add(dictionary_hits, 1);
+                        auto& idx = m_indexes.dictionary_keys[didx.value()];
+                        if (!idx.valid()) {
+                            const auto field = m_dictionary->key_field(didx);
+                            m_keys_data.append(field.data(), field.size());
+                            idx = m_num_keys++;
+                            m_indexes.dictionary_keys_used.push_back(didx.value());
+                        }
+                        return idx;
+                    }
+                }
+                const auto index = m_indexes.keys.find(m_keys_data, text);
                 if (index.valid()) {
+                    vtzero_stats_add(key_dedup_hits, 1);
                     return index;
                 }
+                vtzero_stats_add(key_dedup_misses, 1);
                 return add_key_without_dup_check(text);
             }
 
@@ -207,6 +273,46 @@ namespace vtzero {
                 return add_value(value.data());
             }
 
+            void set_table_index_policy(const table_index_policy policy) noexcept {
+                m_indexes.keys.reset(policy);
+                m_indexes.values.reset(policy);
+            }
+
+            table_index_policy get_table_index_policy() const noexcept {
+                return m_indexes.keys.policy();
+            }
+
+            // Is this key at this position in the key table? This parses
+            // the table up to the position, so it is only used in asserts.
+            bool has_key_at(const uint32_t index, const data_view key) const {
+                protozero::pbf_message<detail::pbf_layer> pbf_table{m_keys_data};
+                for (uint32_t n = 0; pbf_table.next(); ++n) {
+                    if (n == index) {
+                        return pbf_table.get_view() == key;
+                    }
+                    pbf_table.skip();
+                }
+                return false;
+            }
+
+            void use_dictionary(const shared_dictionary& dictionary) {
+                vtzero_assert(m_num_keys == 0 && m_num_values == 0 && "key and value tables must be empty");
+                m_dictionary = &dictionary;
+                m_indexes.dictionary_keys.assign(dictionary.num_keys(), index_value{});
+                m_indexes.dictionary_values.assign(dictionary.num_values(), index_value{});
+                m_indexes.dictionary_keys_used.clear();
+                m_indexes.dictionary_values_used.clear();
+            }
+
+            layer_fragment fragment() const {
+                std::string content;
+                content.reserve(m_data.size() + m_keys_data.size() + m_values_data.size());
+                content += m_data;
+                content += m_keys_data;
+                content += m_values_data;
+                return layer_fragment{std::move(content)};
+            }
+
             const std::string& data() const noexcept {
                 return m_data;
             }
@@ -227,21 +333,51 @@ namespace vtzero {
                 ++m_num_features;
             }
 
-            std::size_t estimated_size() const override {
-                constexpr const std::size_t estimated_overhead_for_pbf_encoding = 8;
-                return data().size() +
-                       keys_data().size() +
-                       values_data().size() +
-                       estimated_overhead_for_pbf_encoding;
+            layer_savepoint savepoint() const noexcept {
+                return layer_savepoint{this,
+                                       m_data.size(),
+                                       m_keys_data.size(),
+                                       m_values_data.size(),
+                                       m_num_features,
+                                       m_num_keys,
+                                       m_num_values};
             }
 
-            void build(protozero::pbf_builder<detail::pbf_tile>& pbf_tile_builder) const override {
-                if (m_num_features > 0) {
-                    pbf_tile_builder.add_bytes_vectored(detail::pbf_tile::layers,
-                                                        data(),
-                                                        keys_data(),
-                                                        values_data());
+            void rollback_to(const layer_savepoint& sp) {
+                vtzero_assert(sp.m_layer == this && "savepoint from a different layer");
+                vtzero_assert(sp.m_data_size <= m_data.size() &&
+                              sp.m_keys_data_size <= m_keys_data.size() &&
+                              sp.m_values_data_size <= m_values_data.size() &&
+                              "savepoint is no longer valid");
+
+                m_indexes.keys.truncate(m_keys_data, sp.m_num_keys, sp.m_keys_data_size);
+                m_indexes.values.truncate(m_values_data, sp.m_num_values, sp.m_values_data_size);
+                remove_from_dictionary_map(sp.m_num_keys, m_indexes.dictionary_keys, m_indexes.dictionary_keys_used);
+                remove_from_dictionary_map(sp.m_num_values, m_indexes.dictionary_values, m_indexes.dictionary_values_used);
+
+                m_data.resize(sp.m_data_size);
+                m_keys_data.resize(sp.m_keys_data_size);
+                m_values_data.resize(sp.m_values_data_size);
+                m_num_features = sp.m_num_features;
+                m_num_keys = sp.m_num_keys;
+                m_num_values = sp.m_num_values;
+            }
+
+            std::size_t encoded_size() const noexcept override {
+                if (m_num_features == 0) {
+                    return 0;
+                }
+                return field_size(m_data.size() + m_keys_data.size() + m_values_data.size());
+            }
+
+            char* write(char* out) const noexcept override {
+                if (m_num_features == 0) {
+                    return out;
                 }
+                out = write_header(out, m_data.size() + m_keys_data.size() + m_values_data.size());
+                out = write_data(out, m_data);
+                out = write_data(out, m_keys_data);
+                return write_data(out, m_values_data);
             }
 
         }; // class layer_builder_impl
@@ -256,17 +392,42 @@ namespace vtzero {
                 m_data(data) {
             }
 
-            std::size_t estimated_size() const override {
-                constexpr const std::size_t estimated_overhead_for_pbf_encoding = 8;
-                return m_data.size() + estimated_overhead_for_pbf_encoding;
+            std::size_t encoded_size() const noexcept override {
+                return field_size(m_data.size());
             }
 
-            void build(protozero::pbf_builder<detail::pbf_tile>& pbf_tile_builder) const override {
-                pbf_tile_builder.add_bytes(detail::pbf_tile::layers, m_data);
+            char* write(char* out) const noexcept override {
+                out = write_header(out, m_data.size());
+                std::copy(m_data.data(), m_data.data() + m_data.size(), out);
+                return out + m_data.size();
             }
 
         }; // class layer_builder_existing
 
+        class layer_builder_fragment : public layer_builder_base {
+
+            layer_fragment m_fragment;
+
+        public:
+
+            explicit layer_builder_fragment(layer_fragment fragment) :
+                m_fragment(std::move(fragment)) {
+                vtzero_assert(m_fragment.valid() && "invalid layer fragment");
+            }
+
+            std::size_t encoded_size() const noexcept override {
+                return field_size(m_fragment.data().size());
+            }
+
+            char* write(char* out) const noexcept override {
+                const auto data = m_fragment.data();
+                out = write_header(out, data.size());
+                std::copy(data.data(), data.data() + data.size(), out);
+                return out + data.size();
+            }
+
+        }; // class layer_builder_fragment
+
     } // namespace detail
 
 } // namespace vtzero
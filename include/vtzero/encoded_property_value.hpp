@@ -16,6 +16,7 @@ documentation.
  * @brief Contains the encoded_property_value class.
  */
 
+#include "hash.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_builder.hpp>
@@ -181,7 +182,7 @@ namespace vtzero {
          * Hash function compatible with std::hash.
          */
         std::size_t hash() const noexcept {
-            return std::hash<std::string>{}(m_data);
+            return static_cast<std::size_t>(detail::hash_bytes(m_data.data(), m_data.size()));
         }
 
     }; // class encoded_property_value
@@ -16,6 +16,7 @@ documentation.
  * @brief Contains the exceptions used in the vtzero library.
  */
 
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -129,6 +130,23 @@ namespace vtzero {
 
     }; // out_of_range_exception
 
+    /**
+     * This exception is thrown when a buffer is too small for the data
+     * that should be written into it.
+     */
+    class buffer_size_exception : public exception {
+
+    public:
+
+        /// Constructor
+        explicit buffer_size_exception(const std::size_t needed, const std::size_t available) :
+            exception(std::string{"buffer too small: need "} +
+                      std::to_string(needed) + " bytes, have " +
+                      std::to_string(available)) {
+        }
+
+    }; // buffer_size_exception
+
 } // namespace vtzero
 
 #endif // VTZERO_EXCEPTION_HPP
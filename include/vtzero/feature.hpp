@@ -19,6 +19,7 @@ documentation.
 #include "exception.hpp"
 #include "property.hpp"
 #include "property_value.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_message.hpp>
@@ -64,6 +65,7 @@ namespace vtzero {
             m_layer(layer) {
             vtzero_assert(layer);
             vtzero_assert(data.data());
+            vtzero_stats_add(features, 1);
 
             protozero::pbf_message<detail::pbf_feature> reader{data};
 
@@ -232,6 +234,8 @@ namespace vtzero {
             }
             const auto ki = *m_property_iterator++;
             const auto vi = *m_property_iterator++;
+            vtzero_stats_add(properties, 1);
+            vtzero_stats_add(varints, 2);
             return {ki, vi};
         }
 
@@ -21,15 +21,23 @@ documentation.
 #include "geometry.hpp"
 #include "property.hpp"
 #include "property_value.hpp"
+#include "stats.hpp"
 
+#include <cstddef>
 #include <utility>
 
 namespace vtzero {
 
+    template <std::size_t N>
+    class layer_schema;
+
     namespace detail {
 
         class feature_builder_base {
 
+            template <std::size_t N>
+            friend class vtzero::layer_schema;
+
             layer_builder_impl* m_layer;
 
             void add_key_internal(index_value idx) {
@@ -100,6 +108,7 @@ namespace vtzero {
                 }
                 m_feature_writer.commit();
                 m_layer->increment_feature_count();
+                vtzero_stats_add(features_committed, 1);
             }
 
             void do_rollback() {
@@ -107,6 +116,7 @@ namespace vtzero {
                     m_pbf_tags.rollback();
                 }
                 m_feature_writer.rollback();
+                vtzero_stats_add(features_rolled_back, 1);
             }
 
         }; // class feature_builder_base
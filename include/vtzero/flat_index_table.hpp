@@ -0,0 +1,247 @@
+#ifndef VTZERO_FLAT_INDEX_TABLE_HPP
+#define VTZERO_FLAT_INDEX_TABLE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file flat_index_table.hpp
+ *
+ * @brief Contains the hash table used by the flat indexes.
+ */
+
+#include "hash.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /**
+         * Open addressing hash table with linear probing used by the flat
+         * indexes. Entries are a one byte type tag plus some payload bytes,
+         * they are stored one after the other in a single string (the
+         * arena), the slots only contain the hash, the position of the entry
+         * in the arena and the index value. So there is no allocation per
+         * entry and lookups can be done with any kind of data without
+         * creating a temporary key first. The slots are only allocated
+         * when the first entry is added (or reserve() is called).
+         */
+        class flat_index_table {
+
+            struct slot {
+                uint32_t hash;
+                uint32_t offset;
+                uint32_t size;
+                index_value value; // invalid for empty slots
+            };
+
+            std::vector<slot> m_slots;
+            std::string m_arena;
+            std::size_t m_size = 0;
+
+            static std::size_t capacity_for(const std::size_t count) noexcept {
+                // keep the load factor below 3/4
+                std::size_t capacity = 16;
+                while (capacity * 3 < count * 4) {
+                    capacity *= 2;
+                }
+                return capacity;
+            }
+
+            std::size_t mask() const noexcept {
+                return m_slots.size() - 1;
+            }
+
+            bool matches(const slot& s, const uint32_t hash, const char tag, const char* data, const std::size_t size) const noexcept {
+                return s.hash == hash &&
+                       s.size == size + 1 &&
+                       m_arena[s.offset] == tag &&
+                       (size == 0 || std::memcmp(m_arena.data() + s.offset + 1, data, size) == 0);
+            }
+
+            // Returns the position of the slot with the entry or of the
+            // empty slot where it would be inserted.
+            std::size_t probe(const uint32_t hash, const char tag, const char* data, const std::size_t size) const noexcept {
+                auto pos = hash & mask();
+                while (m_slots[pos].value.valid() && !matches(m_slots[pos], hash, tag, data, size)) {
+                    pos = (pos + 1) & mask();
+                }
+                return pos;
+            }
+
+            void rehash(const std::size_t capacity) {
+                std::vector<slot> old_slots(capacity, slot{0, 0, 0, index_value{}});
+                swap(old_slots, m_slots);
+                for (const auto& s : old_slots) {
+                    if (s.value.valid()) {
+                        auto pos = s.hash & mask();
+                        while (m_slots[pos].value.valid()) {
+                            pos = (pos + 1) & mask();
+                        }
+                        m_slots[pos] = s;
+                    }
+                }
+            }
+
+        public:
+
+            flat_index_table() = default;
+
+            explicit flat_index_table(const std::size_t expected_size) {
+                if (expected_size > 0) {
+                    reserve(expected_size);
+                }
+            }
+
+            /// Make sure there is room for expected_size entries.
+            void reserve(const std::size_t expected_size) {
+                const auto capacity = capacity_for(expected_size);
+                if (capacity > m_slots.size()) {
+                    rehash(capacity);
+                }
+            }
+
+            /// Remove all entries from the table.
+            void clear() noexcept {
+                for (auto& s : m_slots) {
+                    s.value = index_value{};
+                }
+                m_arena.clear();
+                m_size = 0;
+            }
+
+            /// The number of entries in the table.
+            std::size_t size() const noexcept {
+                return m_size;
+            }
+
+            /// The memory used by the table in bytes.
+            std::size_t capacity() const noexcept {
+                return m_slots.capacity() * sizeof(slot) + m_arena.capacity();
+            }
+
+            /**
+             * Find the entry with the specified tag and data.
+             *
+             * @returns The index value of the entry or an invalid index value
+             *          if it is not in the table.
+             */
+            index_value find(const char tag, const char* data, const std::size_t size) const noexcept {
+                if (m_slots.empty()) {
+                    return index_value{};
+                }
+                const auto hash = static_cast<uint32_t>(hash_bytes(data, size, static_cast<unsigned char>(tag)));
+                return m_slots[probe(hash, tag, data, size)].value;
+            }
+
+            /**
+             * Find the entry with the specified tag and data. If it is not
+             * found, call add() to get the index value for it and store it.
+             */
+            template <typename TAdd>
+            index_value find_or_add(const char tag, const char* data, const std::size_t size, TAdd&& add) {
+                if (m_slots.empty()) {
+                    rehash(capacity_for(0));
+                }
+
+                const auto hash = static_cast<uint32_t>(hash_bytes(data, size, static_cast<unsigned char>(tag)));
+
+                auto pos = probe(hash, tag, data, size);
+                if (m_slots[pos].value.valid()) {
+                    return m_slots[pos].value;
+                }
+
+                const auto idx = std::forward<TAdd>(add)();
+
+                const auto offset = m_arena.size();
+                m_arena += tag;
+                m_arena.append(data, size);
+
+                if ((m_size + 1) * 4 > m_slots.size() * 3) {
+                    rehash(m_slots.size() * 2);
+                    pos = hash & mask();
+                    while (m_slots[pos].value.valid()) {
+                        pos = (pos + 1) & mask();
+                    }
+                }
+
+                m_slots[pos] = slot{hash, static_cast<uint32_t>(offset), static_cast<uint32_t>(size + 1), idx};
+                ++m_size;
+
+                return idx;
+            }
+
+            /**
+             * Remove the entry with the specified tag and data if its index
+             * value is at least first. The slots behind it in the probe
+             * sequence are moved up, so no tombstones are needed. The bytes
+             * of the entry stay in the arena until truncate_arena() is
+             * called.
+             *
+             * @returns The position of the entry in the arena or
+             *          std::string::npos if nothing was removed.
+             */
+            std::size_t erase(const char tag, const char* data, const std::size_t size, const index_value first) noexcept {
+                if (m_slots.empty()) {
+                    return std::string::npos;
+                }
+
+                const auto hash = static_cast<uint32_t>(hash_bytes(data, size, static_cast<unsigned char>(tag)));
+                auto pos = probe(hash, tag, data, size);
+                if (!m_slots[pos].value.valid() || m_slots[pos].value.value() < first.value()) {
+                    return std::string::npos;
+                }
+
+                const std::size_t offset = m_slots[pos].offset;
+                auto next = (pos + 1) & mask();
+                while (m_slots[next].value.valid()) {
+                    // Move the entry into the hole unless its home position
+                    // is (cyclically) between the hole and where it is now.
+                    const auto home = m_slots[next].hash & mask();
+                    const bool stays = pos <= next ? (pos < home && home <= next)
+                                                   : (pos < home || home <= next);
+                    if (!stays) {
+                        m_slots[pos] = m_slots[next];
+                        pos = next;
+                    }
+                    next = (next + 1) & mask();
+                }
+                m_slots[pos].value = index_value{};
+                --m_size;
+
+                return offset;
+            }
+
+            /**
+             * Remove everything from the arena starting at offset.
+             *
+             * @pre No entry in the table must have its data at or after
+             *      offset.
+             */
+            void truncate_arena(const std::size_t offset) {
+                if (offset < m_arena.size()) {
+                    m_arena.resize(offset);
+                }
+            }
+
+        }; // class flat_index_table
+
+    } // namespace detail
+
+} // namespace vtzero
+
+#endif // VTZERO_FLAT_INDEX_TABLE_HPP
@@ -0,0 +1,653 @@
+#ifndef VTZERO_GEOJSON_HPP
+#define VTZERO_GEOJSON_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file geojson.hpp
+ *
+ * @brief Contains the geojson_writer class and functions for writing JSON.
+ */
+
+#include "feature.hpp"
+#include "geometry.hpp"
+#include "layer.hpp"
+#include "property_value.hpp"
+#include "types.hpp"
+#include "vector_tile.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /// Append an unsigned integer in decimal to the output.
+        inline void append_json_uint(std::string& out, uint64_t value) {
+            static const char digits[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+
+            char buffer[20];
+            char* const end = buffer + sizeof(buffer);
+            char* p = end;
+
+            while (value >= 100) {
+                const auto i = static_cast<std::size_t>(value % 100) * 2;
+                value /= 100;
+                *--p = digits[i + 1];
+                *--p = digits[i];
+            }
+
+            if (value >= 10) {
+                const auto i = static_cast<std::size_t>(value) * 2;
+                *--p = digits[i + 1];
+                *--p = digits[i];
+            } else {
+                *--p = static_cast<char>('0' + value);
+            }
+
+            out.append(p, static_cast<std::size_t>(end - p));
+        }
+
+        /// Append a signed integer in decimal to the output.
+        inline void append_json_int(std::string& out, const int64_t value) {
+            if (value < 0) {
+                out += '-';
+                append_json_uint(out, 0 - static_cast<uint64_t>(value));
+            } else {
+                append_json_uint(out, static_cast<uint64_t>(value));
+            }
+        }
+
+        /**
+         * Append a double with at most 17 significant digits so that it
+         * reads back as the same value (round-trip safe). The first of 15,
+         * 16, or 17 digits which reads back correctly is used, this is not
+         * always the shortest representation: 5e-324 is written as
+         * 4.94065645841247e-324. Integral values are written without
+         * decimal point, non-finite values as null (JSON doesn't have them).
+         *
+         * This uses snprintf() and strtod(), so the C locale must use '.'
+         * as decimal point.
+         */
+        inline void append_json_double(std::string& out, const double value) {
+            if (!std::isfinite(value)) {
+                out += "null";
+                return;
+            }
+
+            if (std::trunc(value) == value && std::abs(value) < 9007199254740992.0 /* 2^53 */) {
+                append_json_int(out, static_cast<int64_t>(value));
+                return;
+            }
+
+            char buffer[32];
+            for (int precision = 15; precision <= 17; ++precision) {
+                const int len = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+                if (precision == 17 || std::strtod(buffer, nullptr) == value) {
+                    out.append(buffer, static_cast<std::size_t>(len));
+                    return;
+                }
+            }
+        }
+
+        /**
+         * Append a float with at most 9 significant digits so that it
+         * reads back as the same float value. Works like
+         * append_json_double() trying 6 to 9 digits.
+         */
+        inline void append_json_float(std::string& out, const float value) {
+            const auto d = static_cast<double>(value);
+            if (!std::isfinite(d)) {
+                out += "null";
+                return;
+            }
+
+            if (std::trunc(d) == d && std::abs(d) < 16777216.0 /* 2^24 */) {
+                append_json_int(out, static_cast<int64_t>(d));
+                return;
+            }
+
+            char buffer[32];
+            for (int precision = 6; precision <= 9; ++precision) {
+                const int len = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, d);
+                if (precision == 9 || std::strtof(buffer, nullptr) == value) {
+                    out.append(buffer, static_cast<std::size_t>(len));
+                    return;
+                }
+            }
+        }
+
+        /**
+         * Append a double rounded to the specified number of decimal
+         * places, trailing zeros are removed. This is much faster than
+         * append_json_double(). Falls back to append_json_double() if the
+         * value is too large to be formatted this way.
+         *
+         * @pre @code decimals <= 15 @endcode
+         */
+        inline void append_json_fixed(std::string& out, const double value, const unsigned int decimals) {
+            static const double powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+            };
+            vtzero_assert(decimals <= 15);
+
+            const double scaled = std::round(std::abs(value) * powers[decimals]);
+            if (!(scaled < 9007199254740992.0) /* 2^53, also catches NaN */) {
+                append_json_double(out, value);
+                return;
+            }
+
+            const auto m = static_cast<uint64_t>(scaled);
+            if (value < 0 && m != 0) {
+                out += '-';
+            }
+
+            const auto divisor = static_cast<uint64_t>(powers[decimals]);
+            append_json_uint(out, m / divisor);
+
+            uint64_t fraction = m % divisor;
+            if (fraction == 0) {
+                return;
+            }
+
+            unsigned int digits = decimals;
+            while (fraction % 10 == 0) {
+                fraction /= 10;
+                --digits;
+            }
+
+            out += '.';
+            for (auto f = fraction / 10; f != 0; f /= 10) {
+                --digits;
+            }
+            out.append(digits - 1, '0');
+            append_json_uint(out, fraction);
+        }
+
+        /**
+         * Append a string in double quotes escaping all characters which
+         * need escaping in JSON. Runs of characters which don't need
+         * escaping (usually the whole string) are copied in one go.
+         */
+        inline void append_json_string(std::string& out, const data_view str) {
+            static const char hex[] = "0123456789abcdef";
+
+            out += '"';
+
+            const char* const end = str.data() + str.size();
+            const char* run = str.data();
+            for (const char* it = str.data(); it != end; ++it) {
+                const auto c = static_cast<unsigned char>(*it);
+                if (c >= 0x20 && c != '"' && c != '\\') {
+                    continue;
+                }
+
+                out.append(run, static_cast<std::size_t>(it - run));
+                run = it + 1;
+
+                switch (c) {
+                    case '"':  out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n";  break;
+                    case '\r': out += "\\r";  break;
+                    case '\t': out += "\\t";  break;
+                    case '\b': out += "\\b";  break;
+                    case '\f': out += "\\f";  break;
+                    default:
+                        out += "\\u00";
+                        out += hex[c >> 4u];
+                        out += hex[c & 0xfu];
+                }
+            }
+
+            out.append(run, static_cast<std::size_t>(end - run));
+            out += '"';
+        }
+
+        /// Visitor writing a property value as JSON.
+        struct json_value_visitor {
+
+            std::string* out;
+
+            void operator()(const data_view value) const {
+                append_json_string(*out, value);
+            }
+
+            void operator()(const float value) const {
+                append_json_float(*out, value);
+            }
+
+            void operator()(const double value) const {
+                append_json_double(*out, value);
+            }
+
+            void operator()(const int64_t value) const {
+                append_json_int(*out, value);
+            }
+
+            void operator()(const uint64_t value) const {
+                append_json_uint(*out, value);
+            }
+
+            void operator()(const bool value) const {
+                *out += value ? "true" : "false";
+            }
+
+        }; // struct json_value_visitor
+
+        /// Geometry handler counting the parts of a geometry.
+        struct geojson_part_counter {
+
+            std::vector<ring_type>* ring_types;
+            uint32_t points = 0;
+            uint32_t linestrings = 0;
+
+            explicit geojson_part_counter(std::vector<ring_type>* types) noexcept :
+                ring_types(types) {
+            }
+
+            void points_begin(const uint32_t count) noexcept {
+                points = count;
+            }
+
+            void points_point(const point /*point*/) const noexcept {
+            }
+
+            void points_end() const noexcept {
+            }
+
+            void linestring_begin(const uint32_t /*count*/) noexcept {
+                ++linestrings;
+            }
+
+            void linestring_point(const point /*point*/) const noexcept {
+            }
+
+            void linestring_end() const noexcept {
+            }
+
+            void ring_begin(const uint32_t /*count*/) const noexcept {
+            }
+
+            void ring_point(const point /*point*/) const noexcept {
+            }
+
+            void ring_end(const ring_type type) {
+                ring_types->push_back(type);
+            }
+
+        }; // struct geojson_part_counter
+
+    } // namespace detail
+
+    /**
+     * Writes vector tile features as GeoJSON into a string buffer. The
+     * output is appended to the buffer, so it can be written out and
+     * cleared any time between features.
+     *
+     * By default the coordinates are written as tile coordinates. Call
+     * set_tile() to get WGS84 longitude/latitude instead.
+     *
+     * @code
+     * std::string out;
+     * vtzero::geojson_writer writer{out};
+     * writer.set_tile(14, 8714, 8017);
+     * writer.add_tile(tile);
+     * @endcode
+     */
+    class geojson_writer {
+
+        std::string* m_out;
+        std::vector<ring_type> m_ring_types;
+        double m_scale = 0.0;
+        int m_precision = -2;
+        unsigned int m_decimals = 0;
+        double m_x0 = 0.0;
+        double m_y0 = 0.0;
+        uint32_t m_zoom = 0;
+        uint32_t m_x = 0;
+        uint32_t m_y = 0;
+        bool m_world = false;
+        bool m_first_feature = true;
+
+        // Geometry handler writing the coordinates.
+        struct geometry_writer {
+
+            geojson_writer* writer;
+            const std::vector<ring_type>* ring_types;
+            std::size_t ring = 0;
+            bool multi;
+            bool first = true;
+
+            geometry_writer(geojson_writer* w, const std::vector<ring_type>* types, bool is_multi) noexcept :
+                writer(w),
+                ring_types(types),
+                multi(is_multi) {
+            }
+
+            void append_point(const point p) {
+                if (!first) {
+                    *writer->m_out += ',';
+                }
+                first = false;
+                writer->append_coordinates(p);
+            }
+
+            void points_begin(const uint32_t /*count*/) const noexcept {
+            }
+
+            void points_point(const point p) {
+                append_point(p);
+            }
+
+            void points_end() const noexcept {
+            }
+
+            void linestring_begin(const uint32_t /*count*/) {
+                if (ring > 0) {
+                    *writer->m_out += ',';
+                }
+                ++ring;
+                *writer->m_out += '[';
+                first = true;
+            }
+
+            void linestring_point(const point p) {
+                append_point(p);
+            }
+
+            void linestring_end() {
+                *writer->m_out += ']';
+            }
+
+            void ring_begin(const uint32_t /*count*/) {
+                const bool new_polygon = ring == 0 || (*ring_types)[ring] == ring_type::outer;
+                if (ring > 0) {
+                    *writer->m_out += (multi && new_polygon) ? "],[" : ",";
+                } else if (multi) {
+                    *writer->m_out += '[';
+                }
+                ++ring;
+                *writer->m_out += '[';
+                first = true;
+            }
+
+            void ring_point(const point p) {
+                append_point(p);
+            }
+
+            void ring_end(const ring_type /*type*/) {
+                *writer->m_out += ']';
+            }
+
+        }; // struct geometry_writer
+
+        void append_coordinate(const double value) {
+            if (m_precision == -1) {
+                detail::append_json_double(*m_out, value);
+            } else {
+                detail::append_json_fixed(*m_out, value, m_decimals);
+            }
+        }
+
+        void append_coordinates(const point p) {
+            *m_out += '[';
+            if (m_world) {
+                static const double pi = 3.14159265358979323846;
+                const double wx = (m_x0 + static_cast<double>(p.x)) * m_scale;
+                const double wy = (m_y0 + static_cast<double>(p.y)) * m_scale;
+                append_coordinate(wx * 360.0 - 180.0);
+                *m_out += ',';
+                append_coordinate(std::atan(std::sinh(pi * (1.0 - 2.0 * wy))) * 180.0 / pi);
+            } else {
+                detail::append_json_int(*m_out, p.x);
+                *m_out += ',';
+                detail::append_json_int(*m_out, p.y);
+            }
+            *m_out += ']';
+        }
+
+        void set_extent(const uint32_t extent) noexcept {
+            if (!m_world) {
+                return;
+            }
+            const double size = static_cast<double>(extent) * std::ldexp(1.0, static_cast<int>(m_zoom));
+            m_scale = size > 0.0 ? 1.0 / size : 0.0;
+            m_x0 = static_cast<double>(m_x) * static_cast<double>(extent);
+            m_y0 = static_cast<double>(m_y) * static_cast<double>(extent);
+
+            if (m_precision >= 0) {
+                m_decimals = static_cast<unsigned int>(m_precision);
+            } else if (m_precision == -2) {
+                // Enough decimals to keep the resolution of the tile even
+                // near the poles where a degree of latitude is much shorter
+                // than one tile unit.
+                const auto d = size > 360.0 ? std::ceil(std::log10(size / 360.0)) + 2 : 2.0;
+                m_decimals = d > 15.0 ? 15 : static_cast<unsigned int>(d);
+            }
+        }
+
+        void add_geometry(const geometry& geom) {
+            if (geom.type() == GeomType::UNKNOWN) {
+                *m_out += "null";
+                return;
+            }
+
+            m_ring_types.clear();
+            detail::geojson_part_counter counter{&m_ring_types};
+            decode_geometry(geom, counter);
+
+            bool multi = false;
+            const char* type = "";
+            switch (geom.type()) {
+                case GeomType::POINT:
+                    multi = counter.points > 1;
+                    type = multi ? "MultiPoint" : "Point";
+                    break;
+                case GeomType::LINESTRING:
+                    multi = counter.linestrings > 1;
+                    type = multi ? "MultiLineString" : "LineString";
+                    break;
+                default: { // GeomType::POLYGON
+                        std::size_t polygons = 0;
+                        for (std::size_t i = 0; i < m_ring_types.size(); ++i) {
+                            if (i == 0 || m_ring_types[i] == ring_type::outer) {
+                                ++polygons;
+                            }
+                        }
+                        multi = polygons > 1;
+                        type = multi ? "MultiPolygon" : "Polygon";
+                    }
+                    break;
+            }
+
+            *m_out += "{\"type\":\"";
+            *m_out += type;
+            *m_out += "\",\"coordinates\":";
+
+            const bool brackets = multi || geom.type() == GeomType::POLYGON;
+            if (brackets) {
+                *m_out += '[';
+            }
+
+            geometry_writer gw{this, &m_ring_types, multi};
+            decode_geometry(geom, gw);
+
+            if (multi && geom.type() == GeomType::POLYGON) {
+                *m_out += ']';
+            }
+            if (brackets) {
+                *m_out += ']';
+            }
+            *m_out += '}';
+        }
+
+    public:
+
+        /**
+         * Construct a writer appending to the specified buffer.
+         *
+         * @param out The buffer. It must live as long as the writer.
+         */
+        explicit geojson_writer(std::string& out) noexcept :
+            m_out(&out) {
+        }
+
+        /**
+         * Write coordinates as WGS84 longitude/latitude. The tile
+         * coordinates are transformed using the specified tile address
+         * (Web Mercator) and the extent of each layer.
+         *
+         * @param zoom Zoom level of the tile.
+         * @param x X coordinate of the tile.
+         * @param y Y coordinate of the tile.
+         *
+         * @pre @code zoom <= 32 && x < 2^zoom && y < 2^zoom @endcode
+         */
+        void set_tile(const uint32_t zoom, const uint32_t x, const uint32_t y) noexcept {
+            vtzero_assert_in_noexcept_function(zoom <= 32);
+            vtzero_assert_in_noexcept_function((static_cast<uint64_t>(x) >> zoom) == 0 &&
+                                               (static_cast<uint64_t>(y) >> zoom) == 0);
+            m_zoom = zoom;
+            m_x = x;
+            m_y = y;
+            m_world = true;
+        }
+
+        /**
+         * Set the number of decimal places used for WGS84 coordinates.
+         *
+         * By default this is derived from the zoom level and the extent of
+         * each layer so that the resolution of the tile is kept, which is
+         * much faster than writing them round-trip safe.
+         *
+         * @param decimals Number of decimal places (at most 15). Set to -1
+         *        to write them with at most 17 significant digits reading
+         *        back as the same double (see append_json_double()) and to
+         *        -2 to go back to the default.
+         *
+         * @pre @code decimals >= -2 && decimals <= 15 @endcode
+         */
+        void set_coordinate_precision(const int decimals) noexcept {
+            vtzero_assert_in_noexcept_function(decimals >= -2 && decimals <= 15);
+            m_precision = decimals;
+        }
+
+        /**
+         * Start a FeatureCollection. Features added afterwards will be
+         * separated by commas.
+         */
+        void begin_feature_collection() {
+            *m_out += "{\"type\":\"FeatureCollection\",\"features\":[";
+            m_first_feature = true;
+        }
+
+        /// End a FeatureCollection.
+        void end_feature_collection() {
+            *m_out += "]}\n";
+        }
+
+        /**
+         * Add a feature. The geometry is written as Point, LineString,
+         * or Polygon if it has only one part, otherwise as the Multi*
+         * variant. The name of the layer is added as a foreign member
+         * "layer" of the feature.
+         *
+         * @param layer The layer containing the feature.
+         * @param feature The feature.
+         * @throws format_exception if the layer or feature data is
+         *         ill-formed.
+         * @throws geometry_exception if the geometry is invalid.
+         * @throws out_of_range_exception if a property index is invalid.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         *
+         * @pre @code layer.valid() && feature.valid() @endcode
+         */
+        void add_feature(const layer& layer, const feature& feature) {
+            vtzero_assert(layer.valid() && feature.valid());
+
+            if (!m_first_feature) {
+                *m_out += ",\n";
+            }
+            m_first_feature = false;
+
+            set_extent(layer.extent());
+
+            *m_out += "{\"type\":\"Feature\",\"layer\":";
+            detail::append_json_string(*m_out, layer.name());
+
+            if (feature.has_id()) {
+                *m_out += ",\"id\":";
+                detail::append_json_uint(*m_out, feature.id());
+            }
+
+            *m_out += ",\"geometry\":";
+            add_geometry(feature.geometry());
+
+            *m_out += ",\"properties\":{";
+            bool first = true;
+            const detail::json_value_visitor visitor{m_out};
+            feature.for_each_property([&](const property& p) {
+                if (!first) {
+                    *m_out += ',';
+                }
+                first = false;
+                detail::append_json_string(*m_out, p.key());
+                *m_out += ':';
+                apply_visitor(visitor, p.value());
+                return true;
+            });
+            *m_out += "}}";
+        }
+
+        /**
+         * Add all features of all layers of a tile as one
+         * FeatureCollection.
+         *
+         * @param tile The vector tile.
+         * @throws format_exception if the tile data is ill-formed.
+         * @throws geometry_exception if a geometry is invalid.
+         * @throws out_of_range_exception if a property index is invalid.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         */
+        void add_tile(vector_tile& tile) {
+            begin_feature_collection();
+            while (auto layer = tile.next_layer()) {
+                while (const auto feature = layer.next_feature()) {
+                    add_feature(layer, feature);
+                }
+            }
+            end_feature_collection();
+        }
+
+    }; // class geojson_writer
+
+} // namespace vtzero
+
+#endif // VTZERO_GEOJSON_HPP
@@ -17,12 +17,17 @@ documentation.
  */
 
 #include "exception.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_reader.hpp>
+#include <protozero/varint.hpp>
 
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <limits>
+#include <string>
 #include <utility>
 
 namespace vtzero {
@@ -182,6 +187,7 @@ namespace vtzero {
                 m_end(end),
                 m_max_count(static_cast<uint32_t>(max)) {
                 vtzero_assert(max <= detail::max_command_count());
+                vtzero_stats_add(geometries, 1);
             }
 
             uint32_t count() const noexcept {
@@ -220,6 +226,8 @@ namespace vtzero {
                 }
 
                 ++m_it;
+                vtzero_stats_add(geometry_commands, 1);
+                vtzero_stats_add(varints, 1);
 
                 return true;
             }
@@ -246,6 +254,8 @@ namespace vtzero {
                 m_cursor.y = static_cast<int32_t>(y);
 
                 --m_count;
+                vtzero_stats_add(geometry_points, 1);
+                vtzero_stats_add(varints, 2);
 
                 return m_cursor;
             }
@@ -358,6 +368,66 @@ namespace vtzero {
 
         }; // class geometry_decoder
 
+        /**
+         * Encode a geometry as specified in spec 4.3 into a buffer with the
+         * packed varints of the command stream. Unlike the feature builders
+         * this doesn't check anything, the caller has to make sure the
+         * commands are valid for the geometry type.
+         */
+        class geometry_encoder {
+
+            std::string* m_out;
+
+            point m_cursor{0, 0};
+
+        public:
+
+            explicit geometry_encoder(std::string& out) noexcept :
+                m_out(&out) {
+            }
+
+            /// Clear the buffer and start a new geometry.
+            void clear() noexcept {
+                m_out->clear();
+                m_cursor = point{0, 0};
+            }
+
+            bool empty() const noexcept {
+                return m_out->empty();
+            }
+
+            data_view data() const noexcept {
+                return {m_out->data(), m_out->size()};
+            }
+
+            void add_command(const uint32_t command_integer) {
+                protozero::write_varint(std::back_inserter(*m_out), command_integer);
+            }
+
+            void add_point(const point p) {
+                protozero::write_varint(std::back_inserter(*m_out), protozero::encode_zigzag32(p.x - m_cursor.x));
+                protozero::write_varint(std::back_inserter(*m_out), protozero::encode_zigzag32(p.y - m_cursor.y));
+                m_cursor = p;
+            }
+
+            /// Add a MoveTo and a LineTo command with num_points >= 2 points.
+            void add_path(const point* points, const std::size_t num_points) {
+                add_command(command_move_to(1));
+                add_point(points[0]);
+                add_command(command_line_to(static_cast<uint32_t>(num_points - 1)));
+                for (std::size_t n = 1; n < num_points; ++n) {
+                    add_point(points[n]);
+                }
+            }
+
+            /// Add a ring with num_points >= 3 points (without the closing point).
+            void add_ring(const point* points, const std::size_t num_points) {
+                add_path(points, num_points);
+                add_command(command_close_path());
+            }
+
+        }; // class geometry_encoder
+
     } // namespace detail
 
     /**
@@ -0,0 +1,168 @@
+#ifndef VTZERO_HASH_HPP
+#define VTZERO_HASH_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file hash.hpp
+ *
+ * @brief Contains the hash functions used in vtzero.
+ */
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace vtzero {
+
+    namespace detail {
+
+        constexpr const uint64_t hash_prime1 = 0x9e3779b185ebca87ULL;
+        constexpr const uint64_t hash_prime2 = 0xc2b2ae3d27d4eb4fULL;
+        constexpr const uint64_t hash_prime3 = 0x165667b19e3779f9ULL;
+
+        inline uint64_t hash_read64(const char* data) noexcept {
+            uint64_t v = 0;
+            std::memcpy(&v, data, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t hash_read32(const char* data) noexcept {
+            uint32_t v = 0;
+            std::memcpy(&v, data, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t hash_rotl(const uint64_t x, const unsigned int r) noexcept {
+            return (x << r) | (x >> (64u - r));
+        }
+
+        /**
+         * Mix the bits of a 64 bit integer so that each input bit affects
+         * all output bits (the finalizer from MurmurHash3).
+         */
+        inline uint64_t hash_int(uint64_t x) noexcept {
+            x ^= x >> 33u;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33u;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33u;
+            return x;
+        }
+
+        /**
+         * Hash function for byte sequences optimized for the short strings
+         * found in the key and value tables of vector tiles. Works on 8 byte
+         * words, the last partial word is read with (possibly overlapping)
+         * 4 byte or single byte reads. The result depends on the byte order
+         * of the machine, so it must not be stored anywhere.
+         *
+         * @param data Pointer to the data.
+         * @param size Size of the data.
+         * @param seed Seed, different seeds give different hash functions.
+         */
+        inline uint64_t hash_bytes(const char* data, std::size_t size, const uint64_t seed = 0) noexcept {
+            uint64_t h = (seed + hash_prime3) ^ (static_cast<uint64_t>(size) * hash_prime1);
+
+            while (size >= 8) {
+                h ^= hash_rotl(hash_read64(data) * hash_prime2, 31u) * hash_prime1;
+                h = hash_rotl(h, 27u) * hash_prime1 + hash_prime3;
+                data += 8;
+                size -= 8;
+            }
+
+            uint64_t tail = 0;
+            if (size >= 4) {
+                tail = (hash_read32(data) << 32u) | hash_read32(data + size - 4);
+            } else if (size > 0) {
+                tail = (static_cast<uint64_t>(static_cast<unsigned char>(data[0])) << 16u) |
+                       (static_cast<uint64_t>(static_cast<unsigned char>(data[size / 2])) << 8u) |
+                        static_cast<uint64_t>(static_cast<unsigned char>(data[size - 1]));
+            }
+            h ^= tail * hash_prime2;
+
+            return hash_int(h);
+        }
+
+    } // namespace detail
+
+    /**
+     * Hash function object used as default by the indexes in index.hpp.
+     * Uses the vtzero hash functions for strings and numbers and falls back
+     * to std::hash for everything else.
+     */
+    template <typename T, typename Enable = void>
+    struct hash : std::hash<T> {
+    };
+
+    /// Specialization of vtzero::hash for integer types.
+    template <typename T>
+    struct hash<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+
+        /// calculate the hash of the argument
+        std::size_t operator()(const T value) const noexcept {
+            return static_cast<std::size_t>(detail::hash_int(static_cast<uint64_t>(value)));
+        }
+
+    }; // struct hash
+
+    /// Specialization of vtzero::hash for floating point types.
+    template <typename T>
+    struct hash<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+
+        /// calculate the hash of the argument
+        std::size_t operator()(const T value) const noexcept {
+            // -0.0 and 0.0 compare equal, so they need the same hash
+            const double d = value == 0 ? 0.0 : static_cast<double>(value);
+            uint64_t bits = 0;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return static_cast<std::size_t>(detail::hash_int(bits));
+        }
+
+    }; // struct hash
+
+    /// Specialization of vtzero::hash for std::string.
+    template <>
+    struct hash<std::string> {
+
+        /// calculate the hash of the argument
+        std::size_t operator()(const std::string& value) const noexcept {
+            return static_cast<std::size_t>(detail::hash_bytes(value.data(), value.size()));
+        }
+
+    }; // struct hash
+
+    /// Specialization of vtzero::hash for data_view.
+    template <>
+    struct hash<data_view> {
+
+        /// calculate the hash of the argument
+        std::size_t operator()(const data_view value) const noexcept {
+            return static_cast<std::size_t>(detail::hash_bytes(value.data(), value.size()));
+        }
+
+    }; // struct hash
+
+    /**
+     * Unordered map using vtzero::hash. Can be used as map template for
+     * the indexes in index.hpp and is the default there.
+     */
+    template <typename TKey, typename TValue>
+    using hash_map = std::unordered_map<TKey, TValue, vtzero::hash<TKey>>;
+
+} // namespace vtzero
+
+#endif // VTZERO_HASH_HPP
@@ -17,9 +17,19 @@ documentation.
  */
 
 #include "builder.hpp"
+#include "flat_index_table.hpp"
+#include "hash.hpp"
+#include "property_value.hpp"
+#include "types.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
 #include <vector>
 
 namespace vtzero {
@@ -28,10 +38,11 @@ namespace vtzero {
      * Used to store the mapping between property keys and the index value
      * in the table stored in a layer.
      *
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use (std::map, std::unordered_map,
+     *         vtzero::hash_map or something compatible). Default is
+     *         vtzero::hash_map.
      */
-    template <template <typename...> class TMap>
+    template <template <typename...> class TMap = hash_map>
     class key_index {
 
         layer_builder& m_builder;
@@ -80,10 +91,11 @@ namespace vtzero {
      * @tparam TInternal The type used in the vector tile to encode the value.
      *         Must be one of string/float/double/int/uint/sint/bool_value_type.
      * @tparam TExternal The type for the value used by the user of this class.
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use (std::map, std::unordered_map,
+     *         vtzero::hash_map or something compatible). Default is
+     *         vtzero::hash_map.
      */
-    template <typename TInternal, typename TExternal, template <typename...> class TMap>
+    template <typename TInternal, typename TExternal, template <typename...> class TMap = hash_map>
     class value_index {
 
         layer_builder& m_builder;
@@ -217,10 +229,11 @@ namespace vtzero {
      * encoded form. This is simpler to use than the value_index class, but
      * has a higher overhead.
      *
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use (std::map, std::unordered_map,
+     *         vtzero::hash_map or something compatible). Default is
+     *         vtzero::hash_map.
      */
-    template <template <typename...> class TMap>
+    template <template <typename...> class TMap = hash_map>
     class value_index_internal {
 
         layer_builder& m_builder;
@@ -258,6 +271,482 @@ namespace vtzero {
 
     }; // class value_index_internal
 
+    /**
+     * Used to store the mapping between property keys and the index value
+     * in the table stored in a layer. Uses an open addressing hash table
+     * which stores all keys in one memory block, so it doesn't need an
+     * allocation per key like key_index does.
+     */
+    class key_index_flat {
+
+        layer_builder& m_builder;
+
+        detail::flat_index_table m_table;
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the key table
+         *        we are creating the index for.
+         * @param expected_size The number of different keys expected. If
+         *        this is set, the hash table doesn't have to grow later.
+         */
+        explicit key_index_flat(layer_builder& builder, const std::size_t expected_size = 0) :
+            m_builder(builder),
+            m_table(expected_size) {
+        }
+
+        /**
+         * Get the index value for the specified key. If the key was not in
+         * the table, it will be added.
+         *
+         * @param key The key to store.
+         * @returns The index value of they key.
+         */
+        index_value operator()(const data_view key) {
+            return m_table.find_or_add(0, key.data(), key.size(), [&]() {
+                return m_builder.add_key_without_dup_check(key);
+            });
+        }
+
+    }; // class key_index_flat
+
+    /**
+     * Used to store the mapping between property values of any type and the
+     * index value in the table stored in a layer. Uses an open addressing
+     * hash table which stores all values in one memory block, so it doesn't
+     * need an allocation per value like value_index_internal does.
+     *
+     * Values can be looked up directly as strings (data_view), as any of
+     * the string/float/double/int/uint/sint/bool_value_type types, as
+     * property_value, or as encoded_property_value. A lookup doesn't create
+     * an encoded value, this is only done when a new value is added to the
+     * table. Values of different types are always different, so the
+     * int_value_type 1 is not the same as the uint_value_type 1.
+     */
+    class value_index_flat {
+
+        layer_builder& m_builder;
+
+        detail::flat_index_table m_table;
+
+        template <typename TValue>
+        index_value lookup(const property_value_type type, const char* data, const std::size_t size, const TValue value) {
+            return m_table.find_or_add(static_cast<char>(type), data, size, [&]() {
+                return m_builder.add_value_without_dup_check(encoded_property_value{value});
+            });
+        }
+
+        template <typename TValue>
+        index_value lookup_number(const TValue value) {
+            char buffer[sizeof(value.value)];
+            std::memcpy(buffer, &value.value, sizeof(buffer));
+            return lookup(TValue::pvtype, buffer, sizeof(buffer), value);
+        }
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the value
+         *        table we are creating the index for.
+         * @param expected_size The number of different values expected. If
+         *        this is set, the hash table doesn't have to grow later.
+         */
+        explicit value_index_flat(layer_builder& builder, const std::size_t expected_size = 0) :
+            m_builder(builder),
+            m_table(expected_size) {
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not in
+         * the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const string_value_type value) {
+            return lookup(property_value_type::string_value, value.value.data(), value.value.size(), value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const data_view value) {
+            return operator()(string_value_type{value});
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const char* value) {
+            return operator()(string_value_type{value});
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const std::string& value) {
+            return operator()(string_value_type{value});
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const float_value_type value) {
+            return lookup_number(value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const double_value_type value) {
+            return lookup_number(value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const int_value_type value) {
+            return lookup_number(value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const uint_value_type value) {
+            return lookup_number(value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const sint_value_type value) {
+            return lookup_number(value);
+        }
+
+        /// @copydoc operator()(const string_value_type)
+        index_value operator()(const bool_value_type value) {
+            const char data = value.value ? 1 : 0;
+            return lookup(property_value_type::bool_value, &data, 1, value);
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not in
+         * the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         * @throws format_exception if the property value is ill-formed.
+         * @throws type_exception if the property value doesn't have a valid
+         *         type.
+         */
+        index_value operator()(const property_value value) {
+            switch (value.type()) {
+                case property_value_type::string_value:
+                    return operator()(string_value_type{value.string_value()});
+                case property_value_type::float_value:
+                    return operator()(float_value_type{value.float_value()});
+                case property_value_type::double_value:
+                    return operator()(double_value_type{value.double_value()});
+                case property_value_type::int_value:
+                    return operator()(int_value_type{value.int_value()});
+                case property_value_type::uint_value:
+                    return operator()(uint_value_type{value.uint_value()});
+                case property_value_type::sint_value:
+                    return operator()(sint_value_type{value.sint_value()});
+                default: // case property_value_type::bool_value:
+                    return operator()(bool_value_type{value.bool_value()});
+            }
+        }
+
+        /// @copydoc operator()(const property_value)
+        index_value operator()(const encoded_property_value& value) {
+            return operator()(property_value{value.data()});
+        }
+
+    }; // class value_index_flat
+
+    namespace detail {
+
+        // Offset of value from base as unsigned number. Only valid if
+        // value >= base, works for signed and unsigned types.
+        template <typename T>
+        uint64_t range_offset(const T value, const T base) noexcept {
+            return static_cast<uint64_t>(value) - static_cast<uint64_t>(base);
+        }
+
+    } // namespace detail
+
+    /**
+     * Used to store the mapping between integer property values and the
+     * index value in the table stored in a layer.
+     *
+     * This is very efficient if most of your values are in a known, densly
+     * used range of integers, for instance building heights or levels.
+     * Values in the range from base to base + size - 1 are looked up in a
+     * vector directly, other values are stored in a hash map.
+     *
+     * @tparam TInternal The type used in the vector tile to encode the value.
+     *         Must be one of int/uint/sint_value_type.
+     */
+    template <typename TInternal>
+    class value_index_dense {
+
+        using value_type = typename TInternal::type;
+
+        layer_builder& m_builder;
+
+        value_type m_base;
+
+        std::vector<index_value> m_index;
+
+        hash_map<value_type, index_value> m_outside;
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the value
+         *        table we are creating the index for.
+         * @param base The smallest value of the dense range.
+         * @param size The number of values in the dense range.
+         */
+        value_index_dense(layer_builder& builder, const value_type base, const std::size_t size) :
+            m_builder(builder),
+            m_base(base),
+            m_index(size) {
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not in
+         * the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const value_type value) {
+            if (value >= m_base) {
+                const auto offset = detail::range_offset(value, m_base);
+                if (offset < m_index.size()) {
+                    auto& idx = m_index[static_cast<std::size_t>(offset)];
+                    if (!idx.valid()) {
+                        idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
+                    }
+                    return idx;
+                }
+            }
+
+            auto& idx = m_outside[value];
+            if (!idx.valid()) {
+                idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
+            }
+            return idx;
+        }
+
+    }; // class value_index_dense
+
+    /**
+     * Used to store the mapping between integer property values and the
+     * index value in the table stored in a layer if the range of the values
+     * is not known beforehand.
+     *
+     * The index starts out like value_index_dense with a vector covering
+     * the range of values seen so far, growing it as needed. If the values
+     * become too sparse (the range is more than four times larger than the
+     * number of different values and larger than min_dense_size), it
+     * switches to a hash map.
+     *
+     * @tparam TInternal The type used in the vector tile to encode the value.
+     *         Must be one of int/uint/sint_value_type.
+     */
+    template <typename TInternal>
+    class value_index_adaptive {
+
+        using value_type = typename TInternal::type;
+
+        layer_builder& m_builder;
+
+        value_type m_base{};
+
+        std::vector<index_value> m_index;
+
+        hash_map<value_type, index_value> m_map;
+
+        std::size_t m_count = 0;
+
+        std::size_t m_min_dense_size;
+
+        bool m_dense = true;
+
+        index_value add(const value_type value) {
+            ++m_count;
+            return m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
+        }
+
+        void switch_to_map() {
+            for (std::size_t n = 0; n < m_index.size(); ++n) {
+                if (m_index[n].valid()) {
+                    m_map.emplace(static_cast<value_type>(static_cast<uint64_t>(m_base) + n), m_index[n]);
+                }
+            }
+            m_index.clear();
+            m_index.shrink_to_fit();
+            m_dense = false;
+        }
+
+        // Try to extend the dense range so that it contains value. Returns
+        // false if the range would get too sparse.
+        bool extend(const value_type value) {
+            const value_type new_base = value < m_base ? value : m_base;
+            const auto shift = detail::range_offset(m_base, new_base);
+            const auto top = detail::range_offset(value, new_base);
+            const uint64_t limit = std::numeric_limits<std::size_t>::max() / 2;
+            if (shift > limit || top > limit) {
+                return false;
+            }
+            const auto new_size = std::max(shift + m_index.size(), top + 1);
+
+            if (new_size > m_min_dense_size && new_size / 4 > m_count + 1) {
+                return false;
+            }
+
+            if (new_base != m_base) {
+                std::vector<index_value> index(static_cast<std::size_t>(new_size));
+                std::copy(m_index.begin(), m_index.end(), index.begin() + static_cast<std::ptrdiff_t>(shift));
+                swap(index, m_index);
+                m_base = new_base;
+            } else {
+                m_index.resize(static_cast<std::size_t>(new_size));
+            }
+
+            return true;
+        }
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the value
+         *        table we are creating the index for.
+         * @param min_dense_size The vector is allowed to grow to this size
+         *        regardless of how sparse the values are.
+         */
+        explicit value_index_adaptive(layer_builder& builder, const std::size_t min_dense_size = 256) :
+            m_builder(builder),
+            m_min_dense_size(min_dense_size) {
+        }
+
+        /// Does this index (still) use the dense vector?
+        bool dense() const noexcept {
+            return m_dense;
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not in
+         * the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const value_type value) {
+            if (m_dense) {
+                if (m_index.empty()) {
+                    m_base = value;
+                    m_index.resize(1);
+                }
+                if (value >= m_base && detail::range_offset(value, m_base) < m_index.size()) {
+                    auto& idx = m_index[static_cast<std::size_t>(detail::range_offset(value, m_base))];
+                    if (!idx.valid()) {
+                        idx = add(value);
+                    }
+                    return idx;
+                }
+                if (extend(value)) {
+                    auto& idx = m_index[static_cast<std::size_t>(detail::range_offset(value, m_base))];
+                    idx = add(value);
+                    return idx;
+                }
+                switch_to_map();
+            }
+
+            auto& idx = m_map[value];
+            if (!idx.valid()) {
+                idx = add(value);
+            }
+            return idx;
+        }
+
+    }; // class value_index_adaptive
+
+    /**
+     * Used to store the mapping between floating point property values and
+     * the index value in the table stored in a layer. The values are
+     * rounded to a multiple of the precision given in the constructor
+     * before they are stored, so values which are nearly the same end up
+     * as the same entry in the value table.
+     *
+     * @code
+     * // round to two decimal places
+     * vtzero::value_index_quantized<vtzero::double_value_type> index{lbuilder, 0.01};
+     * index(3.14159); // adds 3.14 to the value table
+     * index(3.1401); // returns same index
+     * @endcode
+     *
+     * @tparam TInternal The type used in the vector tile to encode the value.
+     *         Must be float_value_type or double_value_type.
+     */
+    template <typename TInternal>
+    class value_index_quantized {
+
+        using value_type = typename TInternal::type;
+
+        layer_builder& m_builder;
+
+        double m_precision;
+
+        hash_map<int64_t, index_value> m_index;
+
+        // for values which can not be quantized (NaN, infinity, or too
+        // large), keyed by their bit pattern
+        hash_map<uint64_t, index_value> m_other;
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the value
+         *        table we are creating the index for.
+         * @param precision Values are rounded to a multiple of this.
+         * @pre @code precision > 0 @endcode
+         */
+        value_index_quantized(layer_builder& builder, const double precision) :
+            m_builder(builder),
+            m_precision(precision) {
+            vtzero_assert(precision > 0 && "precision must be larger than 0");
+        }
+
+        /**
+         * Get the index value for the specified value. If the value (after
+         * rounding) was not in the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const value_type value) {
+            const double steps = std::round(static_cast<double>(value) / m_precision);
+            if (std::abs(steps) < 9.0e18) { // false for NaN and infinity
+                const auto q = static_cast<int64_t>(steps);
+                auto& idx = m_index[q];
+                if (!idx.valid()) {
+                    const auto rounded = static_cast<value_type>(static_cast<double>(q) * m_precision);
+                    idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{rounded}});
+                }
+                return idx;
+            }
+
+            const double d = static_cast<double>(value);
+            uint64_t bits = 0;
+            std::memcpy(&bits, &d, sizeof(bits));
+            auto& idx = m_other[bits];
+            if (!idx.valid()) {
+                idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
+            }
+            return idx;
+        }
+
+    }; // class value_index_quantized
+
 } // namespace vtzero
 
 #endif // VTZERO_INDEX_HPP
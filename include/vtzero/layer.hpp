@@ -20,12 +20,14 @@ documentation.
 #include "feature.hpp"
 #include "geometry.hpp"
 #include "property_value.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_message.hpp>
 
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <vector>
 
 namespace vtzero {
@@ -63,6 +65,9 @@ namespace vtzero {
         mutable std::size_t m_value_table_size = 0;
 
         void initialize_tables() const {
+            vtzero_stats_add(table_initializations, 1);
+            vtzero_stats_add(table_entries, m_key_table_size + m_value_table_size);
+
             m_key_table.reserve(m_key_table_size);
             m_key_table_size = 0;
 
@@ -102,6 +107,7 @@ namespace vtzero {
          */
         explicit layer(const data_view data) :
             m_data(data) {
+            vtzero_stats_add(layers, 1);
             protozero::pbf_message<detail::pbf_layer> reader{data};
             while (reader.next()) {
                 switch (reader.tag_and_type()) {
@@ -265,6 +271,11 @@ namespace vtzero {
          */
         data_view key(index_value index) const {
             vtzero_assert(valid());
+            vtzero_stats_add(table_lookups, 1);
+
+            if (!index.valid()) {
+                throw out_of_range_exception{std::numeric_limits<uint32_t>::max()};
+            }
 
             const auto& table = key_table();
             if (index.value() >= table.size()) {
@@ -285,6 +296,11 @@ namespace vtzero {
          */
         property_value value(index_value index) const {
             vtzero_assert(valid());
+            vtzero_stats_add(table_lookups, 1);
+
+            if (!index.valid()) {
+                throw out_of_range_exception{std::numeric_limits<uint32_t>::max()};
+            }
 
             const auto& table = value_table();
             if (index.value() >= table.size()) {
@@ -402,6 +418,8 @@ namespace vtzero {
         for (auto it = m_properties.begin(); it != m_properties.end();) {
             const uint32_t ki = *it++;
             const uint32_t vi = *it++;
+            vtzero_stats_add(properties, 1);
+            vtzero_stats_add(varints, 2);
             if (!std::forward<TFunc>(func)(property{m_layer->key(ki), m_layer->value(vi)})) {
                 return false;
             }
@@ -0,0 +1,116 @@
+#ifndef VTZERO_LAYER_FRAGMENT_HPP
+#define VTZERO_LAYER_FRAGMENT_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file layer_fragment.hpp
+ *
+ * @brief Contains the layer_fragment class.
+ */
+
+#include "layer.hpp"
+#include "types.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace vtzero {
+
+    /**
+     * An encoded layer which can be added to any number of tiles. Unlike
+     * tile_builder::add_existing_layer(data_view) the fragment owns its
+     * data, so there is no need to keep the data around until the tile is
+     * serialized. Copies of a fragment share the same data, which is
+     * reference counted, so adding a fragment to a tile builder doesn't
+     * copy the data. It is only copied into the output when the tile is
+     * serialized.
+     *
+     * This is useful if the same layer (say an all-ocean water layer)
+     * appears in many tiles.
+     *
+     * @code
+     * vtzero::layer_fragment water = ...;
+     * for (...) {
+     *     vtzero::tile_builder tbuilder;
+     *     tbuilder.add_existing_layer(water);
+     *     ...
+     * }
+     * @endcode
+     *
+     * Fragments are immutable, so they can be used from several threads
+     * at the same time.
+     */
+    class layer_fragment {
+
+        std::shared_ptr<const std::string> m_data;
+
+    public:
+
+        /// Construct an empty (invalid) fragment.
+        layer_fragment() noexcept = default;
+
+        /**
+         * Construct a fragment from an encoded layer.
+         *
+         * @param data The encoded layer (the contents of the layer message
+         *        without the protobuf tag and length).
+         */
+        explicit layer_fragment(std::string data) :
+            m_data(std::make_shared<const std::string>(std::move(data))) {
+        }
+
+        /**
+         * Construct a fragment from an existing layer. The data of the
+         * layer is copied once.
+         */
+        explicit layer_fragment(const layer& layer) :
+            layer_fragment(std::string(layer.data().data(), layer.data().size())) {
+        }
+
+        /// Is this a valid fragment?
+        bool valid() const noexcept {
+            return m_data != nullptr;
+        }
+
+        /// Is this a valid fragment?
+        explicit operator bool() const noexcept {
+            return valid();
+        }
+
+        /**
+         * The encoded layer data.
+         *
+         * @pre @code valid() @endcode
+         */
+        data_view data() const noexcept {
+            vtzero_assert_in_noexcept_function(valid());
+            return {m_data->data(), m_data->size()};
+        }
+
+        /**
+         * Get the layer in this fragment.
+         *
+         * @throws format_exception if the layer data is ill-formed.
+         * @throws version_exception if the layer contains an unsupported
+         *         version number (only version 1 and 2 are supported)
+         * @throws any protozero exception if the protobuf encoding is invalid.
+         * @pre @code valid() @endcode
+         */
+        layer get_layer() const {
+            return layer{data()};
+        }
+
+    }; // class layer_fragment
+
+} // namespace vtzero
+
+#endif // VTZERO_LAYER_FRAGMENT_HPP
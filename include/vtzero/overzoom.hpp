@@ -0,0 +1,717 @@
+#ifndef VTZERO_OVERZOOM_HPP
+#define VTZERO_OVERZOOM_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file overzoom.hpp
+ *
+ * @brief Contains functions to cut child tiles out of a parent tile.
+ */
+
+#include "builder.hpp"
+#include "exception.hpp"
+#include "geometry.hpp"
+#include "layer.hpp"
+#include "property_mapper.hpp"
+#include "types.hpp"
+#include "vector_tile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /// The largest zoom level difference supported for overzooming.
+        constexpr const uint32_t max_overzoom = 20;
+
+        /// The largest zoom level difference supported when creating all
+        /// 4^dz child tiles at once.
+        constexpr const uint32_t max_overzoom_children = 8;
+
+        /**
+         * A point in the coordinate system of the parent tile multiplied by
+         * 2^dz, ie. in the resolution of the child tiles. Child tile (x, y)
+         * starts at (x * extent, y * extent) in this coordinate system.
+         */
+        struct overzoom_point {
+            int64_t x;
+            int64_t y;
+        };
+
+        inline bool operator==(const overzoom_point a, const overzoom_point b) noexcept {
+            return a.x == b.x && a.y == b.y;
+        }
+
+        inline bool operator!=(const overzoom_point a, const overzoom_point b) noexcept {
+            return !(a == b);
+        }
+
+        struct overzoom_box {
+
+            int64_t min_x = std::numeric_limits<int64_t>::max();
+            int64_t min_y = std::numeric_limits<int64_t>::max();
+            int64_t max_x = std::numeric_limits<int64_t>::min();
+            int64_t max_y = std::numeric_limits<int64_t>::min();
+
+            overzoom_box() noexcept = default;
+
+            overzoom_box(int64_t x1, int64_t y1, int64_t x2, int64_t y2) noexcept :
+                min_x(x1),
+                min_y(y1),
+                max_x(x2),
+                max_y(y2) {
+            }
+
+            void extend(const overzoom_point p) noexcept {
+                min_x = std::min(min_x, p.x);
+                min_y = std::min(min_y, p.y);
+                max_x = std::max(max_x, p.x);
+                max_y = std::max(max_y, p.y);
+            }
+
+            bool contains(const overzoom_point p) const noexcept {
+                return p.x >= min_x && p.x <= max_x && p.y >= min_y && p.y <= max_y;
+            }
+
+            bool contains(const overzoom_box& other) const noexcept {
+                return other.min_x >= min_x && other.max_x <= max_x &&
+                       other.min_y >= min_y && other.max_y <= max_y;
+            }
+
+        }; // struct overzoom_box
+
+        inline int64_t floor_div(const int64_t a, const int64_t b) noexcept {
+            const int64_t q = a / b;
+            return (a % b != 0 && a < 0) ? q - 1 : q;
+        }
+
+        /**
+         * Clip the segment from a to b to the box using the Liang-Barsky
+         * algorithm. Returns false if the segment is completely outside the
+         * box, otherwise a and b are set to the end points of the clipped
+         * segment. Points on the boundary are rounded to the nearest
+         * integer coordinates.
+         */
+        inline bool clip_segment(overzoom_point& a, overzoom_point& b, const overzoom_box& box) noexcept {
+            const auto dx = static_cast<double>(b.x - a.x);
+            const auto dy = static_cast<double>(b.y - a.y);
+            const double p[4] = {-dx, dx, -dy, dy};
+            const double q[4] = {static_cast<double>(a.x - box.min_x),
+                                 static_cast<double>(box.max_x - a.x),
+                                 static_cast<double>(a.y - box.min_y),
+                                 static_cast<double>(box.max_y - a.y)};
+
+            double t0 = 0.0;
+            double t1 = 1.0;
+            for (int i = 0; i < 4; ++i) {
+                if (p[i] == 0.0) {
+                    if (q[i] < 0.0) {
+                        return false;
+                    }
+                } else {
+                    const double r = q[i] / p[i];
+                    if (p[i] < 0.0) {
+                        if (r > t1) {
+                            return false;
+                        }
+                        t0 = std::max(t0, r);
+                    } else {
+                        if (r < t0) {
+                            return false;
+                        }
+                        t1 = std::min(t1, r);
+                    }
+                }
+            }
+
+            const auto start = a;
+            if (t0 > 0.0) {
+                a.x = start.x + std::llround(t0 * dx);
+                a.y = start.y + std::llround(t0 * dy);
+            }
+            if (t1 < 1.0) {
+                b.x = start.x + std::llround(t1 * dx);
+                b.y = start.y + std::llround(t1 * dy);
+            }
+            return true;
+        }
+
+        /**
+         * Clip a ring (without the closing point) to the box using the
+         * Sutherland-Hodgman algorithm. The result is returned in ring,
+         * tmp is used as scratch space.
+         */
+        inline void clip_ring(std::vector<overzoom_point>& ring, std::vector<overzoom_point>& tmp, const overzoom_box& box) {
+            // x = box.min_x, x = box.max_x, y = box.min_y, y = box.max_y
+            for (int edge = 0; edge < 4 && !ring.empty(); ++edge) {
+                const bool vertical = edge < 2;
+                const int64_t limit = edge == 0 ? box.min_x :
+                                      edge == 1 ? box.max_x :
+                                      edge == 2 ? box.min_y : box.max_y;
+
+                const auto inside = [edge, limit](const overzoom_point p) noexcept {
+                    switch (edge) {
+                        case 0: return p.x >= limit;
+                        case 1: return p.x <= limit;
+                        case 2: return p.y >= limit;
+                        default: return p.y <= limit;
+                    }
+                };
+
+                const auto intersect = [vertical, limit](const overzoom_point a, const overzoom_point b) noexcept {
+                    if (vertical) {
+                        const double t = static_cast<double>(limit - a.x) / static_cast<double>(b.x - a.x);
+                        return overzoom_point{limit, a.y + std::llround(t * static_cast<double>(b.y - a.y))};
+                    }
+                    const double t = static_cast<double>(limit - a.y) / static_cast<double>(b.y - a.y);
+                    return overzoom_point{a.x + std::llround(t * static_cast<double>(b.x - a.x)), limit};
+                };
+
+                tmp.clear();
+                auto prev = ring.back();
+                bool prev_inside = inside(prev);
+                for (const auto cur : ring) {
+                    const bool cur_inside = inside(cur);
+                    if (cur_inside) {
+                        if (!prev_inside) {
+                            tmp.push_back(intersect(prev, cur));
+                        }
+                        tmp.push_back(cur);
+                    } else if (prev_inside) {
+                        tmp.push_back(intersect(prev, cur));
+                    }
+                    prev = cur;
+                    prev_inside = cur_inside;
+                }
+                swap(ring, tmp);
+            }
+        }
+
+        /**
+         * Geometry handler collecting all points of a feature in the
+         * resolution of the child tiles. Keeps track of the parts of the
+         * geometry (the multipoint, linestrings, or rings) and of the
+         * bounding box.
+         */
+        class overzoom_collector {
+
+        public:
+
+            struct part {
+                std::size_t begin;
+                std::size_t end;
+                ring_type type;
+            };
+
+        private:
+
+            std::vector<overzoom_point> m_points;
+            std::vector<part> m_parts;
+            overzoom_box m_bbox;
+            int64_t m_scale;
+
+            void begin_part() {
+                m_parts.push_back(part{m_points.size(), m_points.size(), ring_type::invalid});
+            }
+
+            void add_point(const point p) {
+                const overzoom_point op{p.x * m_scale, p.y * m_scale};
+                m_points.push_back(op);
+                m_bbox.extend(op);
+            }
+
+        public:
+
+            explicit overzoom_collector(const uint32_t dz) noexcept :
+                m_scale(int64_t(1) << dz) {
+            }
+
+            void clear() noexcept {
+                m_points.clear();
+                m_parts.clear();
+                m_bbox = overzoom_box{};
+            }
+
+            const std::vector<overzoom_point>& points() const noexcept {
+                return m_points;
+            }
+
+            const std::vector<part>& parts() const noexcept {
+                return m_parts;
+            }
+
+            const overzoom_box& bbox() const noexcept {
+                return m_bbox;
+            }
+
+            void points_begin(const uint32_t /*count*/) {
+                begin_part();
+            }
+
+            void points_point(const point p) {
+                add_point(p);
+            }
+
+            void points_end() noexcept {
+                m_parts.back().end = m_points.size();
+            }
+
+            void linestring_begin(const uint32_t /*count*/) {
+                begin_part();
+            }
+
+            void linestring_point(const point p) {
+                add_point(p);
+            }
+
+            void linestring_end() noexcept {
+                m_parts.back().end = m_points.size();
+            }
+
+            void ring_begin(const uint32_t /*count*/) {
+                begin_part();
+            }
+
+            void ring_point(const point p) {
+                add_point(p);
+            }
+
+            void ring_end(const ring_type type) noexcept {
+                // the last point is the same as the first, don't keep it
+                m_points.pop_back();
+                m_parts.back().end = m_points.size();
+                m_parts.back().type = type;
+            }
+
+        }; // class overzoom_collector
+
+        /**
+         * Does the actual work for the overzoom functions: Reads all
+         * features of a layer once and writes them into the layer builders
+         * of a square region of child tiles.
+         */
+        class layer_overzoomer {
+
+            // The layer builder and property mapper for one child tile.
+            struct child_layer {
+
+                layer_builder builder;
+                property_mapper mapper;
+
+                child_layer(const layer& layer, const layer_builder& lbuilder) :
+                    builder(lbuilder),
+                    mapper(layer, builder) {
+                }
+
+            }; // struct child_layer
+
+            layer m_layer;
+            int64_t m_extent;
+            int64_t m_buffer;
+
+            // the child tiles this overzoomer writes to: size x size tiles
+            // starting at (min_x, min_y) in row-major order
+            uint32_t m_min_x;
+            uint32_t m_min_y;
+            uint32_t m_size;
+
+            // The tile builders of the child tiles (if any). The layer
+            // builders and mappers for these are only created when the
+            // first feature is added to a child tile.
+            std::vector<tile_builder>* m_tile_builders = nullptr;
+            std::vector<std::unique_ptr<child_layer>> m_children;
+
+            overzoom_collector m_collector;
+            std::vector<index_value_pair> m_properties;
+            std::vector<overzoom_point> m_ring;
+            std::vector<overzoom_point> m_tmp;
+            std::vector<point> m_out;
+            std::string m_geometry_data;
+            geometry_encoder m_encoder{m_geometry_data};
+
+            // convert from collector coordinates to child tile coordinates
+            static point to_child(const overzoom_point p, const int64_t ox, const int64_t oy) noexcept {
+                return {static_cast<int32_t>(p.x - ox), static_cast<int32_t>(p.y - oy)};
+            }
+
+            void add_out_point(const point p) {
+                if (m_out.empty() || m_out.back() != p) {
+                    m_out.push_back(p);
+                }
+            }
+
+            void encode_points(const overzoom_box& box, const bool inside, const int64_t ox, const int64_t oy) {
+                const auto& points = m_collector.points();
+                uint32_t count = 0;
+                for (const auto p : points) {
+                    if (inside || box.contains(p)) {
+                        ++count;
+                    }
+                }
+                if (count == 0) {
+                    return;
+                }
+                m_encoder.add_command(command_move_to(count));
+                for (const auto p : points) {
+                    if (inside || box.contains(p)) {
+                        m_encoder.add_point(to_child(p, ox, oy));
+                    }
+                }
+            }
+
+            void encode_linestrings(const overzoom_box& box, const bool inside, const int64_t ox, const int64_t oy) {
+                const auto& points = m_collector.points();
+                const auto flush = [this]() {
+                    if (m_out.size() >= 2) {
+                        m_encoder.add_path(m_out.data(), m_out.size());
+                    }
+                    m_out.clear();
+                };
+
+                for (const auto& part : m_collector.parts()) {
+                    m_out.clear();
+                    if (inside) {
+                        for (auto n = part.begin; n < part.end; ++n) {
+                            add_out_point(to_child(points[n], ox, oy));
+                        }
+                        flush();
+                        continue;
+                    }
+
+                    for (auto n = part.begin + 1; n < part.end; ++n) {
+                        auto a = points[n - 1];
+                        auto b = points[n];
+                        if (!clip_segment(a, b, box)) {
+                            flush();
+                            continue;
+                        }
+                        const auto ca = to_child(a, ox, oy);
+                        if (!m_out.empty() && m_out.back() != ca) {
+                            flush();
+                        }
+                        add_out_point(ca);
+                        add_out_point(to_child(b, ox, oy));
+                        if (b != points[n]) {
+                            // segment leaves the box
+                            flush();
+                        }
+                    }
+                    flush();
+                }
+            }
+
+            void encode_polygon(const overzoom_box& box, const bool inside, const int64_t ox, const int64_t oy) {
+                const auto& points = m_collector.points();
+                bool drop_inner = false;
+
+                for (const auto& part : m_collector.parts()) {
+                    if (part.type == ring_type::outer) {
+                        drop_inner = false;
+                    } else if (part.type == ring_type::invalid || drop_inner) {
+                        continue;
+                    }
+
+                    m_out.clear();
+                    if (inside) {
+                        for (auto n = part.begin; n < part.end; ++n) {
+                            add_out_point(to_child(points[n], ox, oy));
+                        }
+                    } else {
+                        m_ring.assign(points.begin() + static_cast<std::ptrdiff_t>(part.begin),
+                                      points.begin() + static_cast<std::ptrdiff_t>(part.end));
+                        clip_ring(m_ring, m_tmp, box);
+                        for (const auto p : m_ring) {
+                            add_out_point(to_child(p, ox, oy));
+                        }
+                    }
+                    while (m_out.size() > 1 && m_out.front() == m_out.back()) {
+                        m_out.pop_back();
+                    }
+
+                    int64_t sum = 0;
+                    if (m_out.size() >= 3) {
+                        for (std::size_t n = 0; n < m_out.size(); ++n) {
+                            sum += det(m_out[n], m_out[(n + 1) % m_out.size()]);
+                        }
+                    }
+                    const auto type = sum > 0 ? ring_type::outer :
+                                      sum < 0 ? ring_type::inner : ring_type::invalid;
+                    if (type != part.type) {
+                        drop_inner = (part.type == ring_type::outer);
+                        continue;
+                    }
+
+                    m_encoder.add_ring(m_out.data(), m_out.size());
+                }
+            }
+
+            void add_to_child(const feature& feature, const uint32_t x, const uint32_t y) {
+                const int64_t ox = static_cast<int64_t>(x) * m_extent;
+                const int64_t oy = static_cast<int64_t>(y) * m_extent;
+                const overzoom_box box{ox - m_buffer, oy - m_buffer, ox + m_extent + m_buffer, oy + m_extent + m_buffer};
+                const bool inside = box.contains(m_collector.bbox());
+
+                m_encoder.clear();
+                switch (feature.geometry_type()) {
+                    case GeomType::POINT:
+                        encode_points(box, inside, ox, oy);
+                        break;
+                    case GeomType::LINESTRING:
+                        encode_linestrings(box, inside, ox, oy);
+                        break;
+                    default: // GeomType::POLYGON
+                        encode_polygon(box, inside, ox, oy);
+                }
+
+                if (m_encoder.empty()) {
+                    return;
+                }
+
+                auto& child = get_child((y - m_min_y) * m_size + (x - m_min_x));
+                geometry_feature_builder fbuilder{child.builder};
+                if (feature.has_id()) {
+                    fbuilder.set_id(feature.id());
+                }
+                fbuilder.set_geometry(geometry{m_encoder.data(), feature.geometry_type()});
+                for (const auto idxs : m_properties) {
+                    fbuilder.add_property(child.mapper(idxs));
+                }
+                fbuilder.commit();
+            }
+
+            child_layer& get_child(const std::size_t n) {
+                auto& child = m_children[n];
+                if (!child) {
+                    vtzero_assert(m_tile_builders && "child layer missing");
+                    child.reset(new child_layer{m_layer, layer_builder{(*m_tile_builders)[n],
+                                                                       m_layer.name(),
+                                                                       m_layer.version(),
+                                                                       m_layer.extent()}});
+                }
+                return *child;
+            }
+
+            // the range of child tiles (in one dimension) which overlap the
+            // range from min to max including the buffer
+            std::pair<int64_t, int64_t> child_range(const int64_t min, const int64_t max, const uint32_t first) const noexcept {
+                const int64_t lo = std::max(static_cast<int64_t>(first),
+                                            floor_div(min - m_buffer - 1, m_extent));
+                const int64_t hi = std::min(static_cast<int64_t>(first) + m_size - 1,
+                                            floor_div(max + m_buffer, m_extent));
+                return {lo, hi};
+            }
+
+        public:
+
+            // Overzoomer writing into the layer builder of the child tile
+            // (x, y).
+            layer_overzoomer(const layer& layer,
+                             const uint32_t dz,
+                             const uint32_t buffer,
+                             const uint32_t x,
+                             const uint32_t y,
+                             const layer_builder& lbuilder) :
+                m_layer(layer),
+                m_extent(layer.extent()),
+                m_buffer(buffer),
+                m_min_x(x),
+                m_min_y(y),
+                m_size(1),
+                m_collector(dz) {
+                if (m_extent == 0) {
+                    throw format_exception{"layer extent is zero"};
+                }
+                m_children.emplace_back(new child_layer{m_layer, lbuilder});
+            }
+
+            // Overzoomer writing into the tile builders of all 2^dz x 2^dz
+            // child tiles, layers are only added to the child tiles which
+            // get any features.
+            layer_overzoomer(const layer& layer,
+                             const uint32_t dz,
+                             const uint32_t buffer,
+                             std::vector<tile_builder>& tbuilders) :
+                m_layer(layer),
+                m_extent(layer.extent()),
+                m_buffer(buffer),
+                m_min_x(0),
+                m_min_y(0),
+                m_size(1u << dz),
+                m_tile_builders(&tbuilders),
+                m_collector(dz) {
+                vtzero_assert(tbuilders.size() == static_cast<std::size_t>(m_size) * m_size);
+                if (m_extent == 0) {
+                    throw format_exception{"layer extent is zero"};
+                }
+                m_children.resize(tbuilders.size());
+            }
+
+            void run() {
+                m_layer.reset_feature();
+                while (auto feature = m_layer.next_feature()) {
+                    if (feature.geometry_type() == GeomType::UNKNOWN) {
+                        continue;
+                    }
+
+                    m_collector.clear();
+                    decode_geometry(feature.geometry(), m_collector);
+                    if (m_collector.points().empty()) {
+                        continue;
+                    }
+
+                    const auto& bbox = m_collector.bbox();
+                    const auto xr = child_range(bbox.min_x, bbox.max_x, m_min_x);
+                    const auto yr = child_range(bbox.min_y, bbox.max_y, m_min_y);
+                    if (xr.first > xr.second || yr.first > yr.second) {
+                        continue;
+                    }
+
+                    m_properties.clear();
+                    while (const auto idxs = feature.next_property_indexes()) {
+                        m_properties.push_back(idxs);
+                    }
+
+                    for (auto y = yr.first; y <= yr.second; ++y) {
+                        for (auto x = xr.first; x <= xr.second; ++x) {
+                            add_to_child(feature, static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+                        }
+                    }
+                }
+            }
+
+        }; // class layer_overzoomer
+
+    } // namespace detail
+
+    /**
+     * Cut the data for a child tile out of a layer of a parent tile. The
+     * child tile is dz zoom levels below the parent tile, x and y are the
+     * coordinates of the child tile relative to the parent, ie. they are
+     * between 0 and 2^dz - 1. The child tile uses the same extent as the
+     * parent.
+     *
+     * Features not overlapping the child tile (including the buffer) are
+     * rejected based on their bounding box. Points outside are removed,
+     * linestrings and polygon rings are clipped, coordinates are scaled
+     * to the child tile. Linestrings and rings that become degenerate are
+     * removed. Properties are copied using a property_mapper, so the key
+     * and value tables of the new layer only contain entries needed by the
+     * features in the child tile.
+     *
+     * @param layer The layer of the parent tile.
+     * @param dz The difference in zoom levels between parent and child.
+     * @param x The x coordinate of the child tile relative to the parent.
+     * @param y The y coordinate of the child tile relative to the parent.
+     * @param buffer The buffer around the child tile in its coordinates.
+     * @param lbuilder The layer builder for the layer in the child tile.
+     *        Usually this has the same name, version and extent as the
+     *        layer in the parent tile.
+     * @throws format_exception if the layer data is ill-formed.
+     * @throws geometry_exception if a geometry is invalid.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     * @pre @code dz <= 20 && x < 2^dz && y < 2^dz @endcode
+     */
+    inline void overzoom_layer(const layer& layer,
+                               const uint32_t dz,
+                               const uint32_t x,
+                               const uint32_t y,
+                               const uint32_t buffer,
+                               layer_builder& lbuilder) {
+        vtzero_assert(dz <= detail::max_overzoom && "dz too large");
+        vtzero_assert(x < (1u << dz) && y < (1u << dz) && "child tile coordinates out of range");
+
+        detail::layer_overzoomer overzoomer{layer, dz, buffer, x, y, lbuilder};
+        overzoomer.run();
+    }
+
+    /**
+     * Cut a child tile out of a parent tile. See overzoom_layer() for the
+     * details, this calls it for every layer.
+     *
+     * @param parent The data of the parent tile.
+     * @param dz The difference in zoom levels between parent and child.
+     * @param x The x coordinate of the child tile relative to the parent.
+     * @param y The y coordinate of the child tile relative to the parent.
+     * @param buffer The buffer around the child tile in its coordinates.
+     * @returns The encoded child tile.
+     * @throws format_exception if the tile data is ill-formed.
+     * @throws geometry_exception if a geometry is invalid.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     * @pre @code dz <= 20 && x < 2^dz && y < 2^dz @endcode
+     */
+    inline std::string overzoom_tile(const data_view parent,
+                                     const uint32_t dz,
+                                     const uint32_t x,
+                                     const uint32_t y,
+                                     const uint32_t buffer = 0) {
+        vector_tile tile{parent};
+        tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            layer_builder lbuilder{tbuilder, layer.name(), layer.version(), layer.extent()};
+            overzoom_layer(layer, dz, x, y, buffer, lbuilder);
+        }
+        return tbuilder.serialize();
+    }
+
+    /**
+     * Cut all 4^dz child tiles dz zoom levels below the parent tile out of
+     * the parent tile. This reads each feature of the parent tile only
+     * once and writes it into all child tiles it overlaps. The result is
+     * the same as calling overzoom_tile() for each child tile, but faster.
+     * Layers are only created in the child tiles that get any features.
+     *
+     * @param parent The data of the parent tile.
+     * @param dz The difference in zoom levels between parent and children.
+     * @param buffer The buffer around the child tiles in their coordinates.
+     * @returns The encoded child tiles, the tile (x, y) is at index
+     *          y * 2^dz + x. Child tiles without any data are empty strings.
+     * @throws exception if dz > 8 (that would be more than 65536 tiles).
+     * @throws format_exception if the tile data is ill-formed.
+     * @throws geometry_exception if a geometry is invalid.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     */
+    inline std::vector<std::string> overzoom_tile_children(const data_view parent,
+                                                           const uint32_t dz,
+                                                           const uint32_t buffer = 0) {
+        if (dz > detail::max_overzoom_children) {
+            throw exception{"dz " + std::to_string(dz) + " too large for overzoom_tile_children() (max " +
+                            std::to_string(detail::max_overzoom_children) + ")"};
+        }
+
+        const std::size_t size = 1u << dz;
+        std::vector<tile_builder> tbuilders(size * size);
+
+        vector_tile tile{parent};
+        while (auto layer = tile.next_layer()) {
+            detail::layer_overzoomer overzoomer{layer, dz, buffer, tbuilders};
+            overzoomer.run();
+        }
+
+        std::vector<std::string> children;
+        children.reserve(tbuilders.size());
+        for (const auto& tbuilder : tbuilders) {
+            children.push_back(tbuilder.serialize());
+        }
+        return children;
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_OVERZOOM_HPP
@@ -17,6 +17,7 @@ documentation.
  */
 
 #include "builder.hpp"
+#include "feature.hpp"
 #include "layer.hpp"
 
 #include <vector>
@@ -98,6 +99,20 @@ namespace vtzero {
 
     }; // class property_mapper
 
+    inline void layer_builder::add_feature(const feature& feature, property_mapper& mapper) {
+        geometry_feature_builder feature_builder{*this};
+        if (feature.has_id()) {
+            feature_builder.set_id(feature.id());
+        }
+        feature_builder.set_geometry(feature.geometry());
+        auto f = feature;
+        f.reset_property();
+        while (auto idxs = f.next_property_indexes()) {
+            feature_builder.add_property(mapper(idxs));
+        }
+        feature_builder.commit();
+    }
+
 } // namespace vtzero
 
 #endif // VTZERO_PROPERTY_MAPPER_HPP
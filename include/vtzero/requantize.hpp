@@ -0,0 +1,240 @@
+#ifndef VTZERO_REQUANTIZE_HPP
+#define VTZERO_REQUANTIZE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file requantize.hpp
+ *
+ * @brief Contains the requantize_layer() function.
+ */
+
+#include "builder.hpp"
+#include "exception.hpp"
+#include "geometry.hpp"
+#include "layer.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /**
+         * Geometry handler used by requantize_layer(). It scales all points
+         * it gets from the geometry decoder and directly encodes them again
+         * into a command stream. Consecutive points that end up on the same
+         * spot are merged, linestrings and rings that become degenerate are
+         * dropped.
+         */
+        class requantize_handler {
+
+            geometry_encoder m_encoder;
+            std::vector<point> m_points;
+            int64_t m_old_extent;
+            int64_t m_new_extent;
+
+            // set if an outer ring was dropped, all its inner rings are
+            // dropped then, too
+            bool m_drop_inner = false;
+
+            int32_t scale(const int32_t value) const noexcept {
+                // value * new / old rounded to the nearest integer, rounding
+                // half-way cases up (also for negative values)
+                const int64_t n = 2 * static_cast<int64_t>(value) * m_new_extent + m_old_extent;
+                const int64_t d = 2 * m_old_extent;
+                int64_t q = n / d;
+                if (n % d != 0 && n < 0) {
+                    --q;
+                }
+                return static_cast<int32_t>(q);
+            }
+
+            point scale(const point p) const noexcept {
+                return {scale(p.x), scale(p.y)};
+            }
+
+            void add_scaled_point(const point p) {
+                const auto sp = scale(p);
+                if (m_points.empty() || m_points.back() != sp) {
+                    m_points.push_back(sp);
+                }
+            }
+
+        public:
+
+            requantize_handler(std::string& out, const uint32_t old_extent, const uint32_t new_extent) :
+                m_encoder(out),
+                m_old_extent(old_extent),
+                m_new_extent(new_extent) {
+            }
+
+            void clear() noexcept {
+                m_encoder.clear();
+                m_drop_inner = false;
+            }
+
+            const geometry_encoder& encoder() const noexcept {
+                return m_encoder;
+            }
+
+            void points_begin(const uint32_t count) {
+                m_encoder.add_command(command_move_to(count));
+            }
+
+            void points_point(const point p) {
+                m_encoder.add_point(scale(p));
+            }
+
+            void points_end() const noexcept {
+            }
+
+            void linestring_begin(const uint32_t count) {
+                m_points.clear();
+                m_points.reserve(count);
+            }
+
+            void linestring_point(const point p) {
+                add_scaled_point(p);
+            }
+
+            void linestring_end() {
+                if (m_points.size() >= 2) {
+                    m_encoder.add_path(m_points.data(), m_points.size());
+                }
+            }
+
+            void ring_begin(const uint32_t count) {
+                m_points.clear();
+                m_points.reserve(count);
+            }
+
+            void ring_point(const point p) {
+                add_scaled_point(p);
+            }
+
+            void ring_end(const ring_type type) {
+                if (type == ring_type::outer) {
+                    m_drop_inner = false;
+                } else if (type == ring_type::invalid || m_drop_inner) {
+                    return;
+                }
+
+                // last point is the same as the first point (or collapsed
+                // onto it), it is implicit in the ClosePath command
+                const auto num_points = m_points.size() - 1;
+
+                int64_t sum = 0;
+                if (num_points >= 3) {
+                    for (std::size_t n = 0; n < num_points; ++n) {
+                        sum += det(m_points[n], m_points[n + 1]);
+                    }
+                }
+
+                const auto new_type = sum > 0 ? ring_type::outer :
+                                      sum < 0 ? ring_type::inner : ring_type::invalid;
+                if (new_type != type) {
+                    m_drop_inner = (type == ring_type::outer);
+                    return;
+                }
+
+                m_encoder.add_ring(m_points.data(), num_points);
+            }
+
+        }; // class requantize_handler
+
+    } // namespace detail
+
+    /**
+     * Copy all features of a layer into a layer builder, scaling all
+     * coordinates from the extent of the layer to a new extent. The
+     * geometries are transcoded directly from the command stream without
+     * going through a feature builder: Each point is decoded, scaled,
+     * and encoded again. In linestrings and polygon rings consecutive
+     * points which end up on the same coordinates are merged. Linestrings
+     * with less than two points and rings which become degenerate or
+     * change their winding order are removed, when an outer ring is
+     * removed, its inner rings are removed, too. Features which end up
+     * without any geometry and features with unknown geometry type are
+     * not copied.
+     *
+     * The key and value tables of the layer are copied as they are and the
+     * tags of the features are copied without any changes.
+     *
+     * @code
+     * vtzero::layer_builder lbuilder{tbuilder, layer.name(), layer.version(), 512};
+     * vtzero::requantize_layer(layer, 512, lbuilder);
+     * @endcode
+     *
+     * @param layer The layer to copy.
+     * @param new_extent The new extent. This should be the same extent the
+     *        layer builder was created with.
+     * @param lbuilder The layer builder for the new layer.
+     * @throws format_exception if the layer data is ill-formed.
+     * @throws geometry_exception if a geometry is invalid.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     * @pre @code new_extent > 0 @endcode
+     * @pre The layer builder must be newly created without any keys,
+     *      values, or features.
+     */
+    inline void requantize_layer(const layer& layer, const uint32_t new_extent, layer_builder& lbuilder) {
+        vtzero_assert(new_extent > 0 && "new_extent must be larger than 0");
+
+        if (layer.extent() == 0) {
+            throw format_exception{"layer extent is zero"};
+        }
+
+        uint32_t n = 0;
+        for (const auto key : layer.key_table()) {
+            const auto index = lbuilder.add_key_without_dup_check(key);
+            vtzero_assert(index.value() == n++ && "layer builder must be empty");
+            (void)index;
+        }
+        n = 0;
+        for (const auto value : layer.value_table()) {
+            const auto index = lbuilder.add_value_without_dup_check(value);
+            vtzero_assert(index.value() == n++ && "layer builder must be empty");
+            (void)index;
+        }
+
+        std::string geometry_data;
+        detail::requantize_handler handler{geometry_data, layer.extent(), new_extent};
+
+        auto source = layer;
+        source.reset_feature();
+        while (auto feature = source.next_feature()) {
+            if (feature.geometry_type() == GeomType::UNKNOWN) {
+                continue;
+            }
+
+            handler.clear();
+            decode_geometry(feature.geometry(), handler);
+            if (handler.encoder().empty()) {
+                continue;
+            }
+
+            geometry_feature_builder fbuilder{lbuilder};
+            if (feature.has_id()) {
+                fbuilder.set_id(feature.id());
+            }
+            fbuilder.set_geometry(geometry{handler.encoder().data(), feature.geometry_type()});
+            while (const auto idxs = feature.next_property_indexes()) {
+                fbuilder.add_property(idxs);
+            }
+            fbuilder.commit();
+        }
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_REQUANTIZE_HPP
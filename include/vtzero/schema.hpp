@@ -0,0 +1,319 @@
+#ifndef VTZERO_SCHEMA_HPP
+#define VTZERO_SCHEMA_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file schema.hpp
+ *
+ * @brief Contains the layer_schema class for keys known at compile time.
+ */
+
+#include "builder.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace vtzero {
+
+    namespace detail {
+
+        template <std::size_t... Is>
+        struct index_list {
+            using type = index_list;
+        };
+
+        template <typename A, typename B>
+        struct concat_index_list;
+
+        template <std::size_t... I1, std::size_t... I2>
+        struct concat_index_list<index_list<I1...>, index_list<I2...>> : index_list<I1..., (sizeof...(I1) + I2)...> {
+        };
+
+        // Creates index_list<0, 1, ..., N-1> with logarithmic template
+        // recursion depth.
+        template <std::size_t N>
+        struct make_index_list : concat_index_list<typename make_index_list<N / 2>::type,
+                                                   typename make_index_list<N - N / 2>::type> {
+        };
+
+        template <>
+        struct make_index_list<0> : index_list<> {
+        };
+
+        template <>
+        struct make_index_list<1> : index_list<0> {
+        };
+
+        constexpr uint32_t schema_hash_mix(const uint32_t h) noexcept {
+            return (h ^ (h >> 16u)) * 0x45d9f3bu;
+        }
+
+        constexpr uint32_t schema_hash_step(const char* str, const uint32_t h) noexcept {
+            return *str == '\0' ? schema_hash_mix(h)
+                                : schema_hash_step(str + 1, (h ^ static_cast<uint32_t>(static_cast<unsigned char>(*str))) * 16777619u);
+        }
+
+        /// Hash function for the schema keys (FNV-1a with a seed and a final mix).
+        constexpr uint32_t schema_hash(const char* str, const uint32_t seed) noexcept {
+            return schema_hash_step(str, 2166136261u ^ (seed * 0x9e3779b9u));
+        }
+
+        /// Same as above for use at runtime. Must return the same values.
+        inline uint32_t schema_hash(const data_view str, const uint32_t seed) noexcept {
+            uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+            for (std::size_t n = 0; n < str.size(); ++n) {
+                h = (h ^ static_cast<uint32_t>(static_cast<unsigned char>(str.data()[n]))) * 16777619u;
+            }
+            return schema_hash_mix(h);
+        }
+
+        template <std::size_t N>
+        struct schema_keys {
+            const char* keys[N];
+        };
+
+        // The table size is the smallest power of two >= N*N, this way a
+        // seed without collisions is found after a few tries.
+        constexpr std::size_t schema_table_size(const std::size_t n, const std::size_t size = 1) noexcept {
+            return size >= n * n ? size : schema_table_size(n, size * 2);
+        }
+
+        constexpr uint32_t schema_slot(const char* key, const uint32_t seed, const std::size_t mask) noexcept {
+            return static_cast<uint32_t>(schema_hash(key, seed) & mask);
+        }
+
+        template <std::size_t N>
+        constexpr bool schema_slot_unique(const schema_keys<N>& k, const uint32_t seed, const std::size_t mask, const std::size_t i, const std::size_t j) noexcept {
+            return j >= N || (schema_slot(k.keys[i], seed, mask) != schema_slot(k.keys[j], seed, mask) &&
+                              schema_slot_unique(k, seed, mask, i, j + 1));
+        }
+
+        template <std::size_t N>
+        constexpr bool schema_all_slots_unique(const schema_keys<N>& k, const uint32_t seed, const std::size_t mask, const std::size_t i) noexcept {
+            return i >= N || (schema_slot_unique(k, seed, mask, i, i + 1) &&
+                              schema_all_slots_unique(k, seed, mask, i + 1));
+        }
+
+        // Find the first seed for which all keys end up in different
+        // slots. With duplicate keys there is no such seed and compilation
+        // will fail.
+        template <std::size_t N>
+        constexpr uint32_t schema_find_seed(const schema_keys<N>& k, const std::size_t mask, const uint32_t seed) noexcept {
+            return schema_all_slots_unique(k, seed, mask, 0) ? seed : schema_find_seed(k, mask, seed + 1);
+        }
+
+        // The index of the key which ends up in the slot or N if there is
+        // no such key.
+        template <std::size_t N>
+        constexpr uint8_t schema_slot_entry(const schema_keys<N>& k, const uint32_t seed, const std::size_t mask, const std::size_t slot, const std::size_t i) noexcept {
+            return i >= N ? static_cast<uint8_t>(N)
+                          : schema_slot(k.keys[i], seed, mask) == slot ? static_cast<uint8_t>(i)
+                                                                       : schema_slot_entry(k, seed, mask, slot, i + 1);
+        }
+
+    } // namespace detail
+
+    /**
+     * A list of property keys known at compile time. Used to build layers
+     * with a fixed schema: The keys are added to the key table of a new
+     * layer in the order given (see register_keys()), so the index value
+     * of each key is its position in the schema and properties can be added
+     * to features without any lookup:
+     *
+     * @code
+     * enum road_key : uint32_t { road_class, road_type, road_name };
+     * constexpr auto road_schema = vtzero::make_layer_schema("class", "type", "name");
+     *
+     * vtzero::layer_builder lbuilder{tbuilder, "roads"};
+     * road_schema.register_keys(lbuilder);
+     * ...
+     * road_schema.add_property<road_name>(fbuilder, "Main Street");
+     * @endcode
+     *
+     * For keys only known at runtime, find() looks up the index in a
+     * perfect hash table generated at compile time.
+     *
+     * @tparam N The number of keys (1 to 32).
+     */
+    template <std::size_t N>
+    class layer_schema {
+
+        static_assert(N > 0 && N <= 32, "layer_schema must have between 1 and 32 keys");
+
+        static constexpr const std::size_t table_size = detail::schema_table_size(N);
+
+        detail::schema_keys<N> m_keys;
+        uint32_t m_seed;
+        uint8_t m_table[table_size];
+
+        template <std::size_t... Is>
+        constexpr layer_schema(const detail::schema_keys<N>& keys, const uint32_t seed, detail::index_list<Is...> /*slots*/) noexcept :
+            m_keys(keys),
+            m_seed(seed),
+            m_table{detail::schema_slot_entry(keys, seed, table_size - 1, Is, 0)...} {
+        }
+
+        constexpr explicit layer_schema(const detail::schema_keys<N>& keys) noexcept :
+            layer_schema(keys,
+                         detail::schema_find_seed(keys, table_size - 1, 0),
+                         typename detail::make_index_list<table_size>::type{}) {
+        }
+
+    public:
+
+        /**
+         * Construct a layer schema from a list of keys. The number of keys
+         * must be N, all keys must be different.
+         */
+        template <typename... TKeys>
+        constexpr explicit layer_schema(const char* key, TKeys... keys) noexcept :
+            layer_schema(detail::schema_keys<N>{{key, keys...}}) {
+            static_assert(sizeof...(TKeys) + 1 == N, "number of keys must match template parameter");
+        }
+
+        /// The number of keys in this schema.
+        constexpr std::size_t size() const noexcept {
+            return N;
+        }
+
+        /**
+         * Get the key with the specified index.
+         *
+         * @pre @code n < size() @endcode
+         */
+        constexpr const char* key(const std::size_t n) const noexcept {
+            return m_keys.keys[n];
+        }
+
+        /**
+         * Find the index value of a key at runtime. This needs one hash
+         * calculation and at most one string comparison.
+         *
+         * @param key The key to look for.
+         * @returns The index value of the key or an invalid index value if
+         *          the key is not in the schema.
+         */
+        index_value find(const data_view key) const noexcept {
+            const auto n = m_table[detail::schema_hash(key, m_seed) & (table_size - 1)];
+            if (n < N && key == data_view{m_keys.keys[n]}) {
+                return index_value{n};
+            }
+            return index_value{};
+        }
+
+        /**
+         * Add the keys of this schema to the key table of a layer in the
+         * order they are in the schema, so that the index value of each key
+         * is its position in the schema.
+         *
+         * @param builder The layer builder.
+         * @pre The key table of the layer must be empty.
+         */
+        void register_keys(layer_builder& builder) const {
+            for (std::size_t n = 0; n < N; ++n) {
+                const auto index = builder.add_key_without_dup_check(m_keys.keys[n]);
+                vtzero_assert(index.value() == n && "key table must be empty");
+                (void)index;
+            }
+        }
+
+        /**
+         * Add a property with the key at position KeyIndex in this schema
+         * to a feature. The index value of the key is known at compile
+         * time, so no lookup is needed. Can only be called after all the
+         * methods manipulating the geometry of the feature.
+         *
+         * @tparam KeyIndex The position of the key in the schema. Checked
+         *         at compile time.
+         * @tparam TBuilder The feature builder type.
+         * @tparam TValue Can be type index_value or property_value or
+         *         encoded_property or anything that converts to it.
+         * @param builder The feature builder.
+         * @param value The value.
+         * @pre The keys of this schema must have been registered in the
+         *      layer of the feature using register_keys(). This is checked
+         *      in debug builds.
+         */
+        template <std::size_t KeyIndex, typename TBuilder, typename TValue>
+        void add_property(TBuilder& builder, TValue&& value) const {
+            static_assert(KeyIndex < N, "key index out of range for this layer_schema");
+            vtzero_assert(static_cast<const detail::feature_builder_base&>(builder).m_layer->has_key_at(static_cast<uint32_t>(KeyIndex), m_keys.keys[KeyIndex]) &&
+                          "keys of the layer_schema were not registered in this layer");
+            builder.add_property(index_value{static_cast<uint32_t>(KeyIndex)}, std::forward<TValue>(value));
+        }
+
+    }; // class layer_schema
+
+    template <std::size_t N>
+    constexpr const std::size_t layer_schema<N>::table_size;
+
+    /**
+     * Create a layer_schema from a list of keys.
+     */
+    template <typename... TKeys>
+    constexpr layer_schema<sizeof...(TKeys) + 1> make_layer_schema(const char* key, TKeys... keys) noexcept {
+        return layer_schema<sizeof...(TKeys) + 1>{key, keys...};
+    }
+
+    /**
+     * Key index for layers with a schema. It can be used in the same way as
+     * the key_index class (see index.hpp). Keys from the schema are found
+     * through the perfect hash of the schema, other keys are added to the
+     * key table of the layer as usual.
+     *
+     * @tparam N The number of keys in the schema.
+     */
+    template <std::size_t N>
+    class schema_key_index {
+
+        layer_builder& m_builder;
+
+        const layer_schema<N>& m_schema;
+
+    public:
+
+        /**
+         * Construct index. The keys of the schema are added to the key
+         * table of the layer.
+         *
+         * @param builder The layer we are building containing the key table
+         *        we are creating the index for.
+         * @param schema The schema of the layer.
+         * @pre The key table of the layer must be empty.
+         */
+        schema_key_index(layer_builder& builder, const layer_schema<N>& schema) :
+            m_builder(builder),
+            m_schema(schema) {
+            schema.register_keys(builder);
+        }
+
+        /**
+         * Get the index value for the specified key. If the key was not in
+         * the table, it will be added.
+         *
+         * @param key The key to look for.
+         * @returns The index value of they key.
+         */
+        index_value operator()(const data_view key) {
+            const auto index = m_schema.find(key);
+            if (index.valid()) {
+                return index;
+            }
+            return m_builder.add_key(key);
+        }
+
+    }; // class schema_key_index
+
+} // namespace vtzero
+
+#endif // VTZERO_SCHEMA_HPP
@@ -0,0 +1,190 @@
+#ifndef VTZERO_SHARED_DICTIONARY_HPP
+#define VTZERO_SHARED_DICTIONARY_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file shared_dictionary.hpp
+ *
+ * @brief Contains the shared_dictionary class.
+ */
+
+#include "encoded_property_value.hpp"
+#include "flat_index_table.hpp"
+#include "property_value.hpp"
+#include "types.hpp"
+
+#include <protozero/pbf_builder.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * A set of keys and values used in many layers. When creating many
+     * tiles with the same kind of layers, the same keys and many of the same
+     * values have to be encoded and indexed in each layer again. Instead you
+     * can add them once to a shared_dictionary and attach it to each layer
+     * builder using layer_builder::use_dictionary(). The keys and values are
+     * encoded and hashed only once when they are added to the dictionary.
+     * When a layer builder gets a key or value from the dictionary, it only
+     * needs one hash lookup to find it and copies the already encoded bytes
+     * into its key or value table the first time it is used in the layer.
+     * Keys and values not used in a layer don't end up in its tables.
+     *
+     * @code
+     * vtzero::shared_dictionary dict;
+     * dict.add_key("class");
+     * dict.add_value(vtzero::encoded_property_value{"primary"});
+     *
+     * // for each tile, possibly in many threads
+     * vtzero::layer_builder lbuilder{tbuilder, "roads"};
+     * lbuilder.use_dictionary(dict);
+     * @endcode
+     *
+     * The dictionary must not be changed any more once it is attached to a
+     * layer builder. All const member functions can be called from several
+     * threads at the same time, so a dictionary can be shared between
+     * layer builders in different threads.
+     */
+    class shared_dictionary {
+
+        struct table {
+            std::string data;
+            std::vector<std::size_t> offsets{0};
+            detail::flat_index_table index;
+
+            uint32_t size() const noexcept {
+                return static_cast<uint32_t>(offsets.size() - 1);
+            }
+
+            index_value find(const data_view text) const noexcept {
+                return index.find(0, text.data(), text.size());
+            }
+
+            index_value add(const detail::pbf_layer field, const data_view text) {
+                return index.find_or_add(0, text.data(), text.size(), [&]() {
+                    protozero::pbf_builder<detail::pbf_layer> builder{data};
+                    builder.add_string(field, text);
+                    const index_value idx{size()};
+                    offsets.push_back(data.size());
+                    return idx;
+                });
+            }
+
+            data_view field(const index_value index) const noexcept {
+                vtzero_assert_in_noexcept_function(index.value() < size());
+                const auto begin = offsets[index.value()];
+                return {data.data() + begin, offsets[index.value() + 1] - begin};
+            }
+
+        }; // struct table
+
+        table m_keys;
+        table m_values;
+
+    public:
+
+        /**
+         * Add a key to the dictionary. If it is already in the dictionary,
+         * nothing is added.
+         *
+         * @param key The key.
+         * @returns The index of the key in the dictionary.
+         */
+        index_value add_key(const data_view key) {
+            return m_keys.add(detail::pbf_layer::keys, key);
+        }
+
+        /**
+         * Add a value to the dictionary. If it is already in the dictionary,
+         * nothing is added.
+         *
+         * @param value The value.
+         * @returns The index of the value in the dictionary.
+         */
+        index_value add_value(const encoded_property_value& value) {
+            return m_values.add(detail::pbf_layer::values, value.data());
+        }
+
+        /**
+         * Add a value to the dictionary. If it is already in the dictionary,
+         * nothing is added.
+         *
+         * @param value The value.
+         * @returns The index of the value in the dictionary.
+         */
+        index_value add_value(const property_value value) {
+            return m_values.add(detail::pbf_layer::values, value.data());
+        }
+
+        /// The number of keys in the dictionary.
+        uint32_t num_keys() const noexcept {
+            return m_keys.size();
+        }
+
+        /// The number of values in the dictionary.
+        uint32_t num_values() const noexcept {
+            return m_values.size();
+        }
+
+        /**
+         * Find a key in the dictionary.
+         *
+         * @param key The key.
+         * @returns The index of the key in the dictionary or an invalid
+         *          index value if the key is not in the dictionary.
+         */
+        index_value find_key(const data_view key) const noexcept {
+            return m_keys.find(key);
+        }
+
+        /**
+         * Find a value in the dictionary.
+         *
+         * @param value The encoded value (as returned by
+         *        encoded_property_value::data() or property_value::data()).
+         * @returns The index of the value in the dictionary or an invalid
+         *          index value if the value is not in the dictionary.
+         */
+        index_value find_value(const data_view value) const noexcept {
+            return m_values.find(value);
+        }
+
+        /**
+         * Get the encoded protobuf field (tag, length, and data) for the key
+         * with the specified index as it is stored in the key table of a
+         * layer.
+         *
+         * @pre @code index.value() < num_keys() @endcode
+         */
+        data_view key_field(const index_value index) const noexcept {
+            return m_keys.field(index);
+        }
+
+        /**
+         * Get the encoded protobuf field (tag, length, and data) for the
+         * value with the specified index as it is stored in the value table
+         * of a layer.
+         *
+         * @pre @code index.value() < num_values() @endcode
+         */
+        data_view value_field(const index_value index) const noexcept {
+            return m_values.field(index);
+        }
+
+    }; // class shared_dictionary
+
+} // namespace vtzero
+
+#endif // VTZERO_SHARED_DICTIONARY_HPP
@@ -0,0 +1,141 @@
+#ifndef VTZERO_STATS_HPP
+#define VTZERO_STATS_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file stats.hpp
+ *
+ * @brief Contains the stats struct and the vtzero_stats_add() hook.
+ */
+
+#include <cstdint>
+
+namespace vtzero {
+
+    /**
+     * Counters for the work done by vtzero in the current thread. The
+     * counters are only updated if VTZERO_STATS is defined before any vtzero
+     * header is included, otherwise they stay at 0 and the instrumentation
+     * compiles to nothing.
+     *
+     * @code
+     * #define VTZERO_STATS
+     * #include <vtzero/vector_tile.hpp>
+     * ...
+     * vtzero::thread_stats().clear();
+     * ... // decode a tile
+     * report(vtzero::thread_stats().features);
+     * @endcode
+     *
+     * Instead of defining VTZERO_STATS you can also define your own
+     * vtzero_stats_add(counter, n) macro. It is called with the name of one
+     * of the members of this struct and the amount it should be increased.
+     */
+    struct stats {
+
+        /// Number of vector_tile objects created.
+        uint64_t tiles = 0;
+
+        /// Overall size of the data of all vector_tile objects created.
+        uint64_t tile_bytes = 0;
+
+        /// Number of layer objects created.
+        uint64_t layers = 0;
+
+        /// Number of times the key and value tables of a layer were created.
+        uint64_t table_initializations = 0;
+
+        /// Number of entries in the key and value tables created.
+        uint64_t table_entries = 0;
+
+        /// Number of calls to layer::key() and layer::value().
+        uint64_t table_lookups = 0;
+
+        /// Number of feature objects created.
+        uint64_t features = 0;
+
+        /// Number of properties read from features.
+        uint64_t properties = 0;
+
+        /// Number of geometries decoded.
+        uint64_t geometries = 0;
+
+        /// Number of geometry commands decoded.
+        uint64_t geometry_commands = 0;
+
+        /// Number of geometry points decoded.
+        uint64_t geometry_points = 0;
+
+        /**
+         * Number of varints decoded from geometries and property indexes
+         * (this doesn't include varints decoded by protozero when reading
+         * the protobuf structure).
+         */
+        uint64_t varints = 0;
+
+        /// Number of keys found in the key table when adding them to a layer.
+        uint64_t key_dedup_hits = 0;
+
+        /// Number of keys not found in the key table when adding them to a layer.
+        uint64_t key_dedup_misses = 0;
+
+        /// Number of values found in the value table when adding them to a layer.
+        uint64_t value_dedup_hits = 0;
+
+        /// Number of values not found in the value table when adding them to a layer.
+        uint64_t value_dedup_misses = 0;
+
+        /// Number of keys and values found in a shared_dictionary.
+        uint64_t dictionary_hits = 0;
+
+        /// Number of key or value tables switched from small to flat hash index.
+        uint64_t index_promotions = 0;
+
+        /// Number of features committed in feature builders.
+        uint64_t features_committed = 0;
+
+        /// Number of features rolled back in feature builders.
+        uint64_t features_rolled_back = 0;
+
+        /// Number of tiles serialized by tile builders.
+        uint64_t tiles_serialized = 0;
+
+        /// Overall size of all tiles serialized by tile builders.
+        uint64_t serialized_bytes = 0;
+
+        /// Reset all counters to 0.
+        void clear() noexcept {
+            *this = stats{};
+        }
+
+    }; // struct stats
+
+    /**
+     * The stats for the current thread.
+     */
+    inline stats& thread_stats() noexcept {
+        static thread_local stats s;
+        return s;
+    }
+
+} // namespace vtzero
+
+// @cond internal
+#ifndef vtzero_stats_add
+# ifdef VTZERO_STATS
+#  define vtzero_stats_add(counter, n) (::vtzero::thread_stats().counter += (n))
+# else
+#  define vtzero_stats_add(counter, n) static_cast<void>(0)
+# endif
+#endif
+// @endcond
+
+#endif // VTZERO_STATS_HPP
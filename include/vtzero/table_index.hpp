@@ -0,0 +1,271 @@
+#ifndef VTZERO_TABLE_INDEX_HPP
+#define VTZERO_TABLE_INDEX_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file table_index.hpp
+ *
+ * @brief Contains the indexes used by layer builders to find keys and values
+ *        already in their tables.
+ */
+
+#include "flat_index_table.hpp"
+#include "hash.hpp"
+#include "stats.hpp"
+#include "types.hpp"
+
+#include <protozero/pbf_message.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * The strategy a layer_builder uses to find keys and values already in
+     * its tables when add_key() or add_value() is called. Set with
+     * layer_builder::set_table_index_policy().
+     */
+    enum class table_index_policy {
+        /// Use small_table for small tables and flat_hash for larger ones.
+        automatic = 0,
+        /// Linear search through the hashes of all table entries.
+        small_table = 1,
+        /// Open addressing hash table.
+        flat_hash = 2,
+        /// Don't look for duplicates, always add a new entry.
+        no_dedup = 3
+    };
+
+    namespace detail {
+
+        /**
+         * Index for the key or value table of a layer builder. The index
+         * doesn't keep its own copy of the entries in small_table mode, it
+         * only remembers the hashes and the positions of the entries in the
+         * (encoded) table data. Entries are indexed lazily: On each lookup
+         * all entries added to the table since the last lookup (by whatever
+         * means) are parsed and added to the index.
+         */
+        class table_index {
+
+            // Number of entries up to which the automatic policy uses a
+            // small table. Found with the vtzero-bench-index program: Up to
+            // this size both are about equally fast, but the small table
+            // needs less memory.
+            static constexpr const uint32_t max_entries_small = 16;
+
+            std::vector<uint32_t> m_hashes;
+            std::vector<uint32_t> m_offsets;
+            std::vector<uint32_t> m_sizes;
+
+            flat_index_table m_flat;
+
+            // The size of the table data already indexed.
+            std::size_t m_indexed_size = 0;
+
+            // The number of entries already indexed.
+            uint32_t m_num_indexed = 0;
+
+            table_index_policy m_policy;
+
+            bool m_use_flat;
+
+            void insert(const std::string& data, const data_view entry) {
+                const index_value idx{m_num_indexed++};
+                if (m_use_flat) {
+                    m_flat.find_or_add(0, entry.data(), entry.size(), [idx]() {
+                        return idx;
+                    });
+                    return;
+                }
+
+                m_hashes.push_back(static_cast<uint32_t>(hash_bytes(entry.data(), entry.size())));
+                m_offsets.push_back(static_cast<uint32_t>(entry.data() - data.data()));
+                m_sizes.push_back(static_cast<uint32_t>(entry.size()));
+
+                if (m_policy == table_index_policy::automatic && m_hashes.size() > max_entries_small) {
+                    vtzero_stats_add(index_promotions, 1);
+                    m_use_flat = true;
+                    m_flat.reserve(m_hashes.size() * 2);
+                    for (uint32_t n = 0; n < m_hashes.size(); ++n) {
+                        m_flat.find_or_add(0, data.data() + m_offsets[n], m_sizes[n], [n]() {
+                            return index_value{n};
+                        });
+                    }
+                    m_hashes.clear();
+                    m_offsets.clear();
+                    m_sizes.clear();
+                }
+            }
+
+            void sync(const std::string& data) {
+                if (m_indexed_size == data.size()) {
+                    return;
+                }
+
+                protozero::pbf_message<detail::pbf_layer> pbf_table{data.data() + m_indexed_size, data.size() - m_indexed_size};
+                while (pbf_table.next()) {
+                    insert(data, pbf_table.get_view());
+                }
+                m_indexed_size = data.size();
+            }
+
+        public:
+
+            explicit table_index(const table_index_policy policy = table_index_policy::automatic) noexcept :
+                m_policy(policy),
+                m_use_flat(policy == table_index_policy::flat_hash) {
+            }
+
+            table_index_policy policy() const noexcept {
+                return m_policy;
+            }
+
+            /**
+             * Find an entry in the table.
+             *
+             * @param data The encoded table data.
+             * @param text The entry to look for.
+             * @returns The index value of the entry or an invalid index
+             *          value if it was not found.
+             */
+            index_value find(const std::string& data, const data_view text) {
+                if (m_policy == table_index_policy::no_dedup) {
+                    return index_value{};
+                }
+
+                sync(data);
+
+                if (m_use_flat) {
+                    return m_flat.find(0, text.data(), text.size());
+                }
+
+                const auto hash = static_cast<uint32_t>(hash_bytes(text.data(), text.size()));
+                const auto num = m_hashes.size();
+                for (std::size_t n = 0; n < num; ++n) {
+                    if (m_hashes[n] == hash &&
+                        m_sizes[n] == text.size() &&
+                        std::memcmp(data.data() + m_offsets[n], text.data(), text.size()) == 0) {
+                        return index_value{static_cast<uint32_t>(n)};
+                    }
+                }
+
+                return index_value{};
+            }
+
+            /**
+             * The table will be truncated to num entries and data_size
+             * bytes. Remove everything after that from the index. Must be
+             * called while data still contains the removed entries.
+             */
+            void truncate(const std::string& data, const uint32_t num, const std::size_t data_size) {
+                if (m_num_indexed <= num) {
+                    return;
+                }
+
+                if (m_use_flat) {
+                    // Remove the entries one by one. The entries are added
+                    // to the arena in order, so the first one removed marks
+                    // the new end of the arena.
+                    std::size_t arena_end = std::string::npos;
+                    protozero::pbf_message<detail::pbf_layer> pbf_table{data.data() + data_size, m_indexed_size - data_size};
+                    while (pbf_table.next()) {
+                        const auto entry = pbf_table.get_view();
+                        arena_end = std::min(arena_end, m_flat.erase(0, entry.data(), entry.size(), index_value{num}));
+                    }
+                    m_flat.truncate_arena(arena_end);
+                } else {
+                    m_hashes.resize(num);
+                    m_offsets.resize(num);
+                    m_sizes.resize(num);
+                }
+
+                m_num_indexed = num;
+                m_indexed_size = data_size;
+            }
+
+            /**
+             * Remove all entries from the index and set a new policy. The
+             * memory used by the index is kept.
+             */
+            void reset(const table_index_policy policy) noexcept {
+                m_hashes.clear();
+                m_offsets.clear();
+                m_sizes.clear();
+                m_flat.clear();
+                m_indexed_size = 0;
+                m_num_indexed = 0;
+                m_policy = policy;
+                m_use_flat = (policy == table_index_policy::flat_hash);
+            }
+
+            /// The memory used by the index in bytes.
+            std::size_t capacity() const noexcept {
+                return (m_hashes.capacity() + m_offsets.capacity() + m_sizes.capacity()) * sizeof(uint32_t) +
+                       m_flat.capacity();
+            }
+
+        }; // class table_index
+
+        /**
+         * The indexes of the key and value tables of a layer builder and
+         * the mappings from a shared dictionary to these tables. They are
+         * kept together so that a buffer_pool can hand them on to the next
+         * layer builder with all their memory.
+         */
+        struct layer_indexes {
+
+            table_index keys;
+            table_index values;
+
+            // The mapping from the indexes in the dictionary (if any) to
+            // the indexes in the tables of the layer. Entries are invalid
+            // until the key or value is used in the layer for the first
+            // time.
+            std::vector<index_value> dictionary_keys;
+            std::vector<index_value> dictionary_values;
+
+            // The dictionary indexes of the entries in the mappings above
+            // in the order they were filled in, so a rollback can undo
+            // the last ones.
+            std::vector<uint32_t> dictionary_keys_used;
+            std::vector<uint32_t> dictionary_values_used;
+
+            /// Remove all entries, but keep the memory.
+            void clear() noexcept {
+                keys.reset(table_index_policy::automatic);
+                values.reset(table_index_policy::automatic);
+                dictionary_keys.clear();
+                dictionary_values.clear();
+                dictionary_keys_used.clear();
+                dictionary_values_used.clear();
+            }
+
+            /// The memory used by all indexes and mappings in bytes.
+            std::size_t capacity() const noexcept {
+                return keys.capacity() +
+                       values.capacity() +
+                       (dictionary_keys.capacity() + dictionary_values.capacity()) * sizeof(index_value) +
+                       (dictionary_keys_used.capacity() + dictionary_values_used.capacity()) * sizeof(uint32_t);
+            }
+
+        }; // struct layer_indexes
+
+    } // namespace detail
+
+} // namespace vtzero
+
+#endif // VTZERO_TABLE_INDEX_HPP
@@ -0,0 +1,593 @@
+#ifndef VTZERO_TILE_PATCHER_HPP
+#define VTZERO_TILE_PATCHER_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file tile_patcher.hpp
+ *
+ * @brief Contains the tile_patcher class.
+ */
+
+#include "builder.hpp"
+#include "exception.hpp"
+#include "layer.hpp"
+#include "types.hpp"
+
+#include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /**
+         * Read the protobuf field starting at *data and move *data to the
+         * end of that field. Returns the tag and wire type of the field
+         * and sets content to the payload if the field is length delimited.
+         * This is needed where the exact byte range of a field is
+         * important and not only its content.
+         */
+        inline uint32_t next_field(const char** data, const char* end, data_view& content) {
+            const auto tag_and_type = static_cast<uint32_t>(protozero::decode_varint(data, end));
+            switch (static_cast<protozero::pbf_wire_type>(tag_and_type & 0x7u)) {
+                case protozero::pbf_wire_type::varint:
+                    protozero::skip_varint(data, end);
+                    break;
+                case protozero::pbf_wire_type::fixed64:
+                    if (end - *data < 8) {
+                        throw protozero::end_of_buffer_exception{};
+                    }
+                    *data += 8;
+                    break;
+                case protozero::pbf_wire_type::length_delimited: {
+                        const auto len = protozero::decode_varint(data, end);
+                        if (static_cast<uint64_t>(end - *data) < len) {
+                            throw protozero::end_of_buffer_exception{};
+                        }
+                        content = data_view{*data, static_cast<std::size_t>(len)};
+                        *data += len;
+                    }
+                    break;
+                case protozero::pbf_wire_type::fixed32:
+                    if (end - *data < 4) {
+                        throw protozero::end_of_buffer_exception{};
+                    }
+                    *data += 4;
+                    break;
+                default:
+                    throw protozero::unknown_pbf_wire_type_exception{};
+            }
+            return tag_and_type;
+        }
+
+        /**
+         * Append a piece of data to a list of pieces. Empty pieces are
+         * dropped and a piece directly following the last one in memory
+         * is merged with it, so consecutive unchanged byte ranges are
+         * copied in one go later.
+         */
+        inline void add_piece(std::vector<data_view>& pieces, const data_view piece) {
+            if (piece.size() == 0) {
+                return;
+            }
+            if (!pieces.empty() && pieces.back().data() + pieces.back().size() == piece.data()) {
+                pieces.back() = data_view{pieces.back().data(), pieces.back().size() + piece.size()};
+                return;
+            }
+            pieces.push_back(piece);
+        }
+
+        /**
+         * Holds the changes for one layer of a tile_patcher. The layer can
+         * be renamed, in which case only the name field is replaced and all
+         * other bytes are kept. New features are written using a
+         * layer_builder_impl which is pre-seeded with the key and value
+         * tables of the existing layer. This way the index values used by
+         * the existing features stay the same and only new keys and values
+         * are appended to the tables. The builder is only created when
+         * features are changed.
+         */
+        class layer_patch {
+
+            struct feature_edit {
+                uint64_t id;
+                std::size_t begin; // range in m_builder->data() with the
+                std::size_t end;   // replacement (empty when removing)
+
+                bool is_removal() const noexcept {
+                    return begin == end;
+                }
+            };
+
+            layer m_layer;
+
+            // new name and the complete encoded name field if renamed
+            std::string m_name;
+            std::string m_name_field;
+
+            std::unique_ptr<layer_builder_impl> m_builder;
+
+            std::vector<feature_edit> m_edits;
+
+            std::size_t m_data_offset = 0;
+            std::size_t m_keys_offset = 0;
+            std::size_t m_values_offset = 0;
+
+            static uint64_t feature_id(const data_view feature_data, bool& has_id) {
+                protozero::pbf_message<pbf_feature> reader{feature_data};
+                has_id = reader.next(pbf_feature::id, protozero::pbf_wire_type::varint);
+                return has_id ? reader.get_uint64() : 0;
+            }
+
+        public:
+
+            explicit layer_patch(const layer& layer) :
+                m_layer(layer) {
+            }
+
+            data_view name() const noexcept {
+                return m_name_field.empty() ? m_layer.name() : data_view{m_name.data(), m_name.size()};
+            }
+
+            void rename(const data_view name) {
+                m_name.assign(name.data(), name.size());
+                m_name_field.clear();
+                protozero::pbf_builder<pbf_layer> pbf_name{m_name_field};
+                pbf_name.add_string(pbf_layer::name, m_name);
+            }
+
+            layer_builder_impl* builder() {
+                if (!m_builder) {
+                    m_builder.reset(new layer_builder_impl{m_layer.name(), m_layer.version(), m_layer.extent()});
+                    for (const auto key : m_layer.key_table()) {
+                        m_builder->add_key_without_dup_check(key);
+                    }
+                    for (const auto value : m_layer.value_table()) {
+                        m_builder->add_value_without_dup_check(value);
+                    }
+                    m_data_offset = m_builder->data().size();
+                    m_keys_offset = m_builder->keys_data().size();
+                    m_values_offset = m_builder->values_data().size();
+                }
+                return m_builder.get();
+            }
+
+            std::size_t data_size() {
+                return builder()->data().size();
+            }
+
+            bool has_edit(const uint64_t id) const {
+                return std::any_of(m_edits.begin(), m_edits.end(), [id](const feature_edit& e) {
+                    return e.id == id;
+                });
+            }
+
+            void check_no_edit(const uint64_t id) const {
+                if (has_edit(id)) {
+                    throw exception{"feature with id " + std::to_string(id) + " already removed or replaced in layer '" + std::string(name()) + "'"};
+                }
+            }
+
+            // Removals only need the ID, so they don't create the builder.
+            void add_removal(const uint64_t id) {
+                m_edits.push_back(feature_edit{id, 0, 0});
+            }
+
+            void add_edit(const uint64_t id, const std::size_t begin, const std::size_t end) {
+                m_edits.push_back(feature_edit{id, begin, end});
+            }
+
+            /**
+             * Append the pieces making up the content of the patched layer
+             * to the list of pieces and return their overall size.
+             */
+            std::size_t add_pieces(std::vector<data_view>& pieces) const {
+                std::size_t size = 0;
+                const auto add = [&pieces, &size](const data_view piece) {
+                    size += piece.size();
+                    add_piece(pieces, piece);
+                };
+                std::vector<bool> edit_done(m_edits.size(), false);
+
+                const char* it = m_layer.data().data();
+                const char* const end = it + m_layer.data().size();
+                const char* run_begin = it;
+                while (it != end) {
+                    const char* const field_begin = it;
+                    data_view content;
+                    const auto tag_and_type = next_field(&it, end, content);
+
+                    if (tag_and_type == protozero::tag_and_type(pbf_layer::name, protozero::pbf_wire_type::length_delimited)) {
+                        if (!m_name_field.empty()) {
+                            add(data_view{run_begin, static_cast<std::size_t>(field_begin - run_begin)});
+                            add(data_view{m_name_field.data(), m_name_field.size()});
+                            run_begin = it;
+                        }
+                        continue;
+                    }
+
+                    if (m_edits.empty() ||
+                        tag_and_type != protozero::tag_and_type(pbf_layer::features, protozero::pbf_wire_type::length_delimited)) {
+                        continue;
+                    }
+
+                    bool has_id = false;
+                    const auto id = feature_id(content, has_id);
+                    if (!has_id) {
+                        continue;
+                    }
+
+                    const auto edit = std::find_if(m_edits.begin(), m_edits.end(), [id](const feature_edit& e) {
+                        return e.id == id;
+                    });
+                    if (edit == m_edits.end()) {
+                        continue;
+                    }
+
+                    // cut out the existing feature and put the replacement
+                    // (if any) in its place
+                    add(data_view{run_begin, static_cast<std::size_t>(field_begin - run_begin)});
+                    run_begin = it;
+                    const auto n = static_cast<std::size_t>(std::distance(m_edits.begin(), edit));
+                    if (!edit_done[n]) {
+                        edit_done[n] = true;
+                        if (!edit->is_removal()) {
+                            add(data_view{m_builder->data().data() + edit->begin, edit->end - edit->begin});
+                        }
+                    }
+                }
+                add(data_view{run_begin, static_cast<std::size_t>(end - run_begin)});
+
+                if (m_builder) {
+                    const auto& new_data = m_builder->data();
+
+                    // all new features which have not been used as a
+                    // replacement for an existing feature are appended at
+                    // the end
+                    std::vector<feature_edit> used;
+                    for (std::size_t n = 0; n < m_edits.size(); ++n) {
+                        if (edit_done[n] && !m_edits[n].is_removal()) {
+                            used.push_back(m_edits[n]);
+                        }
+                    }
+                    std::sort(used.begin(), used.end(), [](const feature_edit& a, const feature_edit& b) {
+                        return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
+                    });
+                    std::size_t pos = m_data_offset;
+                    for (const auto& edit : used) {
+                        add(data_view{new_data.data() + pos, edit.begin - pos});
+                        pos = edit.end;
+                    }
+                    add(data_view{new_data.data() + pos, new_data.size() - pos});
+
+                    const auto& keys_data = m_builder->keys_data();
+                    add(data_view{keys_data.data() + m_keys_offset, keys_data.size() - m_keys_offset});
+
+                    const auto& values_data = m_builder->values_data();
+                    add(data_view{values_data.data() + m_values_offset, values_data.size() - m_values_offset});
+                }
+
+                return size;
+            }
+
+        }; // class layer_patch
+
+    } // namespace detail
+
+    /**
+     * Used to change some layers or features in an existing vector tile
+     * without decoding and rebuilding the whole tile. Layers can be
+     * removed, renamed, and reordered, this only moves their bytes around.
+     * Layers that are not touched otherwise are copied over as they are,
+     * in renamed layers only the name field is replaced, in layers with
+     * changed features only those features are removed or added. New keys
+     * and values needed by added features are appended to the key and
+     * value tables of the layer, the existing entries are kept as they
+     * are.
+     *
+     * @code
+     * std::string data = ...;
+     * vtzero::tile_patcher patcher{data};
+     * patcher.remove_layer("internal");
+     * patcher.rename_layer("poi_label", "pois");
+     * patcher.remove_feature("roads", 17);
+     * patcher.replace_feature("pois", 42, some_feature);
+     * vtzero::point_feature_builder fb{patcher.patch_layer("pois")};
+     * ...
+     * std::string new_data = patcher.serialize();
+     * @endcode
+     *
+     * All functions taking a layer name use the current name of the layer,
+     * ie. the new name after a rename_layer(). The data of the original
+     * tile must stay available until serialize() is called.
+     */
+    class tile_patcher {
+
+        // the complete layer fields (including tag and length) and the
+        // layers in the original tile
+        std::vector<data_view> m_fields;
+        std::vector<layer> m_layers;
+
+        std::vector<std::unique_ptr<detail::layer_patch>> m_patches;
+
+        // indexes into m_layers in the order of the layers in the output
+        std::vector<std::size_t> m_order;
+
+        data_view current_name(const std::size_t n) const noexcept {
+            return m_patches[n] ? m_patches[n]->name() : m_layers[n].name();
+        }
+
+        std::vector<std::size_t>::iterator find_layer(const data_view layer_name) {
+            return std::find_if(m_order.begin(), m_order.end(), [this, &layer_name](const std::size_t n) {
+                return current_name(n) == layer_name;
+            });
+        }
+
+        std::vector<std::size_t>::iterator get_layer(const data_view layer_name) {
+            const auto it = find_layer(layer_name);
+            if (it == m_order.end()) {
+                throw exception{"no layer named '" + std::string(layer_name) + "' in tile"};
+            }
+            return it;
+        }
+
+        detail::layer_patch& get_patch(const data_view layer_name) {
+            const auto n = *get_layer(layer_name);
+            auto& patch = m_patches[n];
+            if (!patch) {
+                patch.reset(new detail::layer_patch{m_layers[n]});
+            }
+
+            return *patch;
+        }
+
+    public:
+
+        /**
+         * Construct the tile_patcher from the data of an existing vector
+         * tile. The tile_patcher will keep a reference to the data, no copy
+         * of the data is created.
+         *
+         * @throws format_exception if the tile data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is invalid.
+         */
+        explicit tile_patcher(const data_view data) {
+            const char* it = data.data();
+            const char* const end = it + data.size();
+            while (it != end) {
+                const char* const field_begin = it;
+                data_view content;
+                const auto tag_and_type = detail::next_field(&it, end, content);
+                if (tag_and_type == protozero::tag_and_type(detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited)) {
+                    m_layers.emplace_back(content);
+                    m_fields.emplace_back(field_begin, static_cast<std::size_t>(it - field_begin));
+                    m_order.push_back(m_order.size());
+                }
+            }
+            m_patches.resize(m_layers.size());
+        }
+
+        /**
+         * The number of layers that will be in the patched tile.
+         */
+        std::size_t count_layers() const noexcept {
+            return m_order.size();
+        }
+
+        /**
+         * Remove the layer with the specified name from the tile. If there
+         * are several layers with this name, only the first one is removed.
+         *
+         * @param layer_name The name of the layer.
+         * @returns true if a layer was removed, false if there is no layer
+         *          with this name.
+         */
+        bool remove_layer(const data_view layer_name) {
+            const auto it = find_layer(layer_name);
+            if (it == m_order.end()) {
+                return false;
+            }
+            m_order.erase(it);
+            return true;
+        }
+
+        /**
+         * Rename a layer. Only the name field of the layer is replaced,
+         * all other data of the layer stays the same.
+         *
+         * The vector tile spec requires layer names to be unique. This is
+         * not checked.
+         *
+         * @param layer_name The current name of the layer.
+         * @param new_name The new name of the layer.
+         * @throws exception if there is no layer with the specified name.
+         */
+        void rename_layer(const data_view layer_name, const data_view new_name) {
+            get_patch(layer_name).rename(new_name);
+        }
+
+        /**
+         * Move a layer to a different position in the tile.
+         *
+         * @param layer_name The name of the layer.
+         * @param position The new (zero-based) position of the layer. If
+         *        this is larger than the number of layers, the layer is
+         *        moved to the end.
+         * @throws exception if there is no layer with the specified name.
+         */
+        void move_layer(const data_view layer_name, std::size_t position) {
+            const auto it = get_layer(layer_name);
+            const auto n = *it;
+            m_order.erase(it);
+            position = std::min(position, m_order.size());
+            m_order.insert(m_order.begin() + static_cast<std::ptrdiff_t>(position), n);
+        }
+
+        /**
+         * Keep only the layers with the specified names in the order given.
+         * All other layers are removed. Names of layers not in the tile are
+         * ignored. This can be used to extract some layers from a tile or
+         * to reorder all layers.
+         *
+         * @param layer_names The names of the layers to keep.
+         */
+        void select_layers(const std::vector<data_view>& layer_names) {
+            std::vector<std::size_t> order;
+            order.reserve(layer_names.size());
+            for (const auto& layer_name : layer_names) {
+                const auto it = find_layer(layer_name);
+                if (it != m_order.end()) {
+                    order.push_back(*it);
+                    m_order.erase(it);
+                }
+            }
+            m_order.swap(order);
+        }
+
+        /**
+         * Remove the feature with the specified ID from the specified
+         * layer. If there are several features with this ID, all of them
+         * are removed. If this is the only kind of change to a layer, the
+         * remaining features and the key and value tables are copied
+         * over as they are.
+         *
+         * @param layer_name The name of the layer.
+         * @param id The ID of the feature.
+         * @throws exception if there is no layer with the specified name or
+         *         if the feature with this ID was already removed or
+         *         replaced.
+         */
+        void remove_feature(const data_view layer_name, const uint64_t id) {
+            auto& patch = get_patch(layer_name);
+            patch.check_no_edit(id);
+            patch.add_removal(id);
+        }
+
+        /**
+         * Replace the feature with the specified ID in the specified layer
+         * by a copy of the given feature. The new feature will be at the
+         * position of the feature it replaces. If there is no feature with
+         * the specified ID, the new feature is added at the end of the
+         * layer.
+         *
+         * @param layer_name The name of the layer.
+         * @param id The ID of the feature to replace.
+         * @param feature The new feature, usually from a different tile.
+         * @throws exception if there is no layer with the specified name or
+         *         if the feature with this ID was already removed or
+         *         replaced.
+         */
+        void replace_feature(const data_view layer_name, const uint64_t id, const feature& feature) {
+            auto& patch = get_patch(layer_name);
+            patch.check_no_edit(id);
+            const auto begin = patch.data_size();
+            layer_builder{patch.builder()}.add_feature(feature);
+            patch.add_edit(id, begin, patch.data_size());
+        }
+
+        /**
+         * Add a copy of the given feature at the end of the specified layer.
+         *
+         * @param layer_name The name of the layer.
+         * @param feature The new feature, usually from a different tile.
+         * @throws exception if there is no layer with the specified name.
+         */
+        void add_feature(const data_view layer_name, const feature& feature) {
+            layer_builder{get_patch(layer_name).builder()}.add_feature(feature);
+        }
+
+        /**
+         * Get a layer_builder which can be used with the usual feature
+         * builders to add new features at the end of the specified layer.
+         *
+         * @param layer_name The name of the layer.
+         * @returns layer_builder for the specified layer.
+         * @throws exception if there is no layer with the specified name.
+         */
+        layer_builder patch_layer(const data_view layer_name) {
+            return layer_builder{get_patch(layer_name).builder()};
+        }
+
+        /**
+         * Serialize the patched vector tile. The data will be appended to
+         * the specified buffer. The buffer doesn't have to be empty.
+         *
+         * The output is assembled from a list of pieces in one pass, most
+         * of them pointing into the original tile data, so unchanged byte
+         * ranges are only copied once.
+         *
+         * @param buffer Buffer to append the encoded vector tile to.
+         */
+        void serialize(std::string& buffer) const {
+            std::vector<data_view> pieces;
+            pieces.reserve(m_order.size());
+
+            // The tags and lengths of changed layers. Enough space is
+            // reserved so the string never reallocates and the pieces can
+            // point into it.
+            std::string prefixes;
+            prefixes.reserve(m_order.size() * (1 + protozero::max_varint_length));
+
+            for (const auto n : m_order) {
+                if (!m_patches[n]) {
+                    detail::add_piece(pieces, m_fields[n]);
+                    continue;
+                }
+
+                const auto prefix_piece = pieces.size();
+                pieces.emplace_back();
+                const auto size = m_patches[n]->add_pieces(pieces);
+
+                const auto begin = prefixes.size();
+                protozero::write_varint(std::back_inserter(prefixes),
+                                        protozero::tag_and_type(detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited));
+                protozero::write_varint(std::back_inserter(prefixes), size);
+                pieces[prefix_piece] = data_view{prefixes.data() + begin, prefixes.size() - begin};
+            }
+
+            std::size_t size = 0;
+            for (const auto& piece : pieces) {
+                size += piece.size();
+            }
+
+            buffer.reserve(buffer.size() + size);
+            for (const auto& piece : pieces) {
+                buffer.append(piece.data(), piece.size());
+            }
+        }
+
+        /**
+         * Serialize the patched vector tile and return it.
+         *
+         * If you want to use an existing buffer instead, use the serialize()
+         * method taking a std::string& as parameter.
+         *
+         * @returns std::string Buffer with encoded vector_tile data.
+         */
+        std::string serialize() const {
+            std::string data;
+            serialize(data);
+            return data;
+        }
+
+    }; // class tile_patcher
+
+} // namespace vtzero
+
+#endif // VTZERO_TILE_PATCHER_HPP
@@ -18,6 +18,7 @@ documentation.
 
 #include "exception.hpp"
 #include "layer.hpp"
+#include "stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_message.hpp>
@@ -67,6 +68,8 @@ namespace vtzero {
         explicit vector_tile(const data_view data) noexcept :
             m_data(data),
             m_tile_reader(m_data) {
+            vtzero_stats_add(tiles, 1);
+            vtzero_stats_add(tile_bytes, m_data.size());
         }
 
         /**
@@ -77,6 +80,8 @@ namespace vtzero {
         explicit vector_tile(const std::string& data) noexcept :
             m_data(data.data(), data.size()),
             m_tile_reader(m_data) {
+            vtzero_stats_add(tiles, 1);
+            vtzero_stats_add(tile_bytes, m_data.size());
         }
 
         /**
@@ -87,6 +92,8 @@ namespace vtzero {
         vector_tile(const char* data, std::size_t size) noexcept :
             m_data(data, size),
             m_tile_reader(m_data) {
+            vtzero_stats_add(tiles, 1);
+            vtzero_stats_add(tile_bytes, m_data.size());
         }
 
         /**
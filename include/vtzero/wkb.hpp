@@ -0,0 +1,398 @@
+#ifndef VTZERO_WKB_HPP
+#define VTZERO_WKB_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file wkb.hpp
+ *
+ * @brief Contains the wkb_geometry_handler class and functions for writing
+ *        geometries as WKB.
+ */
+
+#include "geometry.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vtzero {
+
+    /// Geometry types in WKB.
+    enum class wkb_type : uint32_t {
+        point              = 1,
+        linestring         = 2,
+        polygon            = 3,
+        multipoint         = 4,
+        multilinestring    = 5,
+        multipolygon       = 6
+    }; // enum class wkb_type
+
+    namespace detail {
+
+        /// Flag in the geometry type of EWKB showing that a SRID follows.
+        constexpr const uint32_t ewkb_srid_flag = 0x20000000U;
+
+        /// Size of the byte order marker and geometry type.
+        constexpr const std::size_t wkb_header_size = 1 + 4;
+
+        /// Size of a point (two doubles).
+        constexpr const std::size_t wkb_point_size = 2 * 8;
+
+        inline void write_wkb_uint32(char*& out, const uint32_t value) noexcept {
+            *out++ = static_cast<char>(value & 0xffU);
+            *out++ = static_cast<char>((value >> 8U) & 0xffU);
+            *out++ = static_cast<char>((value >> 16U) & 0xffU);
+            *out++ = static_cast<char>((value >> 24U) & 0xffU);
+        }
+
+        inline void write_wkb_double(char*& out, const double value) noexcept {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 8; ++i) {
+                *out++ = static_cast<char>(bits & 0xffU);
+                bits >>= 8U;
+            }
+        }
+
+        inline void write_wkb_header(char*& out, const wkb_type type) noexcept {
+            *out++ = 1; // little endian
+            write_wkb_uint32(out, static_cast<uint32_t>(type));
+        }
+
+        /**
+         * Geometry handler used by the wkb_geometry_handler to find out
+         * how many parts a geometry has and how large its WKB will be.
+         */
+        struct wkb_part_counter {
+
+            std::vector<uint32_t>* ring_counts;
+            std::size_t points = 0;
+            uint32_t parts = 0;
+
+            explicit wkb_part_counter(std::vector<uint32_t>* counts) noexcept :
+                ring_counts(counts) {
+            }
+
+            void points_begin(const uint32_t count) noexcept {
+                points = count;
+                parts = count;
+            }
+
+            void points_point(const point /*point*/) const noexcept {
+            }
+
+            void points_end() const noexcept {
+            }
+
+            void linestring_begin(const uint32_t count) noexcept {
+                points += count;
+                ++parts;
+            }
+
+            void linestring_point(const point /*point*/) const noexcept {
+            }
+
+            void linestring_end() const noexcept {
+            }
+
+            void ring_begin(const uint32_t count) noexcept {
+                points += count;
+            }
+
+            void ring_point(const point /*point*/) const noexcept {
+            }
+
+            void ring_end(const ring_type type) {
+                // The first ring and each outer ring start a new polygon,
+                // all other rings are holes in the current polygon.
+                if (ring_counts->empty() || type == ring_type::outer) {
+                    ring_counts->push_back(1);
+                } else {
+                    ++ring_counts->back();
+                }
+            }
+
+        }; // struct wkb_part_counter
+
+    } // namespace detail
+
+    /**
+     * Geometry handler for decode_geometry() writing the geometry as
+     * little-endian WKB (or EWKB with SRID) directly into a buffer.
+     *
+     * WKB needs the number of parts of a geometry before the parts
+     * themselves and, for polygons, which rings belong to which polygon.
+     * So the geometry is first scanned by calling prepare(). This also
+     * calculates the exact size of the WKB and resizes the buffer
+     * accordingly. Decoding the geometry with this handler then writes
+     * the WKB into the space reserved in the buffer. No memory is
+     * allocated while doing this except for a small vector with the number
+     * of rings per polygon which is reused if the handler is reused.
+     *
+     * Single points, linestrings, and polygons are written as Point,
+     * LineString, and Polygon, respectively, otherwise Multi* geometries
+     * are written. Coordinates are written as tile coordinates.
+     *
+     * @code
+     * std::string wkb;
+     * vtzero::wkb_geometry_handler handler;
+     * handler.prepare(feature.geometry(), wkb);
+     * vtzero::decode_geometry(feature.geometry(), handler);
+     * @endcode
+     */
+    class wkb_geometry_handler {
+
+        std::vector<uint32_t> m_ring_counts{};
+        char* m_out = nullptr;
+        char* m_end = nullptr;
+        std::size_t m_polygon = 0;
+        uint32_t m_parts = 0;
+        uint32_t m_ring = 0;
+        uint32_t m_srid = 0;
+        bool m_ewkb = false;
+        bool m_multi = false;
+
+        void write_header(const wkb_type type) noexcept {
+            *m_out++ = 1; // little endian
+            if (m_ewkb) {
+                detail::write_wkb_uint32(m_out, static_cast<uint32_t>(type) | detail::ewkb_srid_flag);
+                detail::write_wkb_uint32(m_out, m_srid);
+            } else {
+                detail::write_wkb_uint32(m_out, static_cast<uint32_t>(type));
+            }
+        }
+
+        void write_point(const point p) noexcept {
+            detail::write_wkb_double(m_out, static_cast<double>(p.x));
+            detail::write_wkb_double(m_out, static_cast<double>(p.y));
+        }
+
+        void write_point_check(const point p) noexcept {
+            vtzero_assert_in_noexcept_function(m_out + detail::wkb_point_size <= m_end && "call prepare() first");
+            write_point(p);
+        }
+
+    public:
+
+        /// Construct a handler writing WKB.
+        wkb_geometry_handler() = default;
+
+        /**
+         * Construct a handler writing EWKB (as used by PostGIS) with the
+         * specified SRID.
+         *
+         * @param srid The spatial reference system identifier.
+         */
+        explicit wkb_geometry_handler(const uint32_t srid) noexcept :
+            m_srid(srid),
+            m_ewkb(true) {
+        }
+
+        /**
+         * Get the size of the WKB for the geometry in bytes. Also
+         * remembers the structure of the geometry for a later call to
+         * decode_geometry().
+         *
+         * @param geometry The geometry.
+         * @returns The number of bytes needed for the WKB.
+         * @throws geometry_exception if the geometry is invalid.
+         */
+        std::size_t prepare_size(const geometry& geometry) {
+            m_ring_counts.clear();
+            m_polygon = 0;
+            m_ring = 0;
+
+            detail::wkb_part_counter counter{&m_ring_counts};
+            decode_geometry(geometry, counter);
+            m_parts = counter.parts;
+
+            std::size_t size = detail::wkb_header_size + (m_ewkb ? 4 : 0);
+            switch (geometry.type()) {
+                case GeomType::POINT:
+                    m_multi = counter.parts != 1;
+                    if (m_multi) {
+                        size += 4 + counter.parts * (detail::wkb_header_size + detail::wkb_point_size);
+                    } else {
+                        size += detail::wkb_point_size;
+                    }
+                    break;
+                case GeomType::LINESTRING:
+                    m_multi = counter.parts != 1;
+                    size += 4 + counter.points * detail::wkb_point_size;
+                    if (m_multi) {
+                        size += counter.parts * (detail::wkb_header_size + 4);
+                    }
+                    break;
+                default: { // GeomType::POLYGON
+                        m_multi = m_ring_counts.size() != 1;
+                        std::size_t rings = 0;
+                        for (const auto count : m_ring_counts) {
+                            rings += count;
+                        }
+                        size += 4 + rings * 4 + counter.points * detail::wkb_point_size;
+                        if (m_multi) {
+                            size += m_ring_counts.size() * (detail::wkb_header_size + 4);
+                        }
+                    }
+                    break;
+            }
+
+            return size;
+        }
+
+        /**
+         * Prepare writing the geometry into the specified memory. This
+         * writes the header of the geometry, the rest is written when
+         * calling decode_geometry() with this handler.
+         *
+         * @param geometry The geometry.
+         * @param data Pointer to the memory for the WKB.
+         * @param size Size of the memory. Must be the size returned by
+         *        prepare_size().
+         * @pre prepare_size() must have been called with the same geometry.
+         */
+        void prepare_output(const geometry& geometry, char* data, const std::size_t size) noexcept {
+            m_out = data;
+            m_end = data + size;
+            switch (geometry.type()) {
+                case GeomType::POINT:
+                    write_header(m_multi ? wkb_type::multipoint : wkb_type::point);
+                    break;
+                case GeomType::LINESTRING:
+                    write_header(m_multi ? wkb_type::multilinestring : wkb_type::linestring);
+                    break;
+                default: // GeomType::POLYGON
+                    write_header(m_multi ? wkb_type::multipolygon : wkb_type::polygon);
+                    if (m_multi) {
+                        m_parts = static_cast<uint32_t>(m_ring_counts.size());
+                    } else {
+                        // number of rings of the only polygon
+                        detail::write_wkb_uint32(m_out, m_ring_counts.front());
+                    }
+                    break;
+            }
+            if (m_multi) {
+                detail::write_wkb_uint32(m_out, m_parts);
+            }
+        }
+
+        /**
+         * Prepare writing the geometry: Scans the geometry, resizes the
+         * buffer to make room for the WKB and writes the header. The WKB
+         * will be appended to the buffer, it doesn't have to be empty.
+         * Call decode_geometry() with this handler afterwards to write
+         * the rest of the WKB. The buffer must not be changed in between.
+         *
+         * @tparam TBuffer Buffer type. Must have size(), resize(), and
+         *         operator[] like std::string or std::vector<char>.
+         * @param geometry The geometry.
+         * @param buffer The buffer to append the WKB to.
+         * @throws geometry_exception if the geometry is invalid. The buffer
+         *         is unchanged in this case.
+         */
+        template <typename TBuffer>
+        void prepare(const geometry& geometry, TBuffer& buffer) {
+            const auto size = prepare_size(geometry);
+            const auto old_size = buffer.size();
+            buffer.resize(old_size + size);
+            prepare_output(geometry, &buffer[old_size], size);
+        }
+
+        /// @cond internal
+
+        void points_begin(const uint32_t /*count*/) const noexcept {
+        }
+
+        void points_point(const point p) noexcept {
+            if (m_multi) {
+                detail::write_wkb_header(m_out, wkb_type::point);
+            }
+            write_point_check(p);
+        }
+
+        void points_end() const noexcept {
+        }
+
+        void linestring_begin(const uint32_t count) noexcept {
+            if (m_multi) {
+                detail::write_wkb_header(m_out, wkb_type::linestring);
+            }
+            detail::write_wkb_uint32(m_out, count);
+        }
+
+        void linestring_point(const point p) noexcept {
+            write_point_check(p);
+        }
+
+        void linestring_end() const noexcept {
+        }
+
+        void ring_begin(const uint32_t count) noexcept {
+            if (m_multi && m_ring == 0) {
+                detail::write_wkb_header(m_out, wkb_type::polygon);
+                detail::write_wkb_uint32(m_out, m_ring_counts[m_polygon]);
+            }
+            detail::write_wkb_uint32(m_out, count);
+        }
+
+        void ring_point(const point p) noexcept {
+            write_point_check(p);
+        }
+
+        void ring_end(const ring_type /*type*/) noexcept {
+            if (++m_ring == m_ring_counts[m_polygon]) {
+                ++m_polygon;
+                m_ring = 0;
+            }
+        }
+
+        /// @endcond
+
+    }; // class wkb_geometry_handler
+
+    /**
+     * Append the geometry as WKB to the buffer.
+     *
+     * @tparam TBuffer Buffer type. Must have size(), resize(), and
+     *         operator[] like std::string or std::vector<char>.
+     * @param geometry The geometry.
+     * @param buffer The buffer to append the WKB to.
+     * @throws geometry_exception if the geometry is invalid.
+     */
+    template <typename TBuffer>
+    void write_wkb(const geometry& geometry, TBuffer& buffer) {
+        wkb_geometry_handler handler;
+        handler.prepare(geometry, buffer);
+        decode_geometry(geometry, handler);
+    }
+
+    /**
+     * Append the geometry as EWKB with the specified SRID to the buffer.
+     *
+     * @tparam TBuffer Buffer type. Must have size(), resize(), and
+     *         operator[] like std::string or std::vector<char>.
+     * @param geometry The geometry.
+     * @param buffer The buffer to append the EWKB to.
+     * @param srid The spatial reference system identifier.
+     * @throws geometry_exception if the geometry is invalid.
+     */
+    template <typename TBuffer>
+    void write_ewkb(const geometry& geometry, TBuffer& buffer, const uint32_t srid) {
+        wkb_geometry_handler handler{srid};
+        handler.prepare(geometry, buffer);
+        decode_geometry(geometry, handler);
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_WKB_HPP
@@ -0,0 +1,564 @@
+#ifndef VTZERO_WKB_IMPORT_HPP
+#define VTZERO_WKB_IMPORT_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file wkb_import.hpp
+ *
+ * @brief Contains the tile_transform class and functions for adding
+ *        geometries in WKB format to feature builders.
+ */
+
+#include "builder.hpp"
+#include "exception.hpp"
+#include "geometry.hpp"
+#include "types.hpp"
+#include "wkb.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace vtzero {
+
+    /**
+     * Transformation from world coordinates (for instance Web Mercator) to
+     * tile coordinates. The y axis is flipped, so the maximum y coordinate
+     * of the tile bounds ends up at the top of the tile.
+     *
+     * Coordinates are rounded to the nearest integer. Coordinates outside
+     * the tile plus buffer are clamped to it. This keeps them in range but
+     * it is no replacement for clipping the geometries.
+     */
+    class tile_transform {
+
+        double m_min_x;
+        double m_max_y;
+        double m_scale_x;
+        double m_scale_y;
+        double m_min;
+        double m_max;
+
+        double clamp(const double value) const noexcept {
+            // written this way to also catch NaN
+            if (!(value >= m_min)) {
+                return m_min;
+            }
+            if (value > m_max) {
+                return m_max;
+            }
+            return std::floor(value + 0.5);
+        }
+
+    public:
+
+        /**
+         * Construct a transformation from the specified tile bounds in
+         * world coordinates.
+         *
+         * @param min_x Left edge of the tile.
+         * @param min_y Bottom edge of the tile.
+         * @param max_x Right edge of the tile.
+         * @param max_y Top edge of the tile.
+         * @param extent Extent of the tile.
+         * @param buffer Buffer around the tile in tile coordinates.
+         *
+         * @pre @code min_x < max_x && min_y < max_y @endcode
+         */
+        tile_transform(const double min_x, const double min_y,
+                       const double max_x, const double max_y,
+                       const uint32_t extent = 4096, const uint32_t buffer = 0) noexcept :
+            m_min_x(min_x),
+            m_max_y(max_y),
+            m_scale_x(static_cast<double>(extent) / (max_x - min_x)),
+            m_scale_y(static_cast<double>(extent) / (max_y - min_y)),
+            m_min(-static_cast<double>(buffer)),
+            m_max(static_cast<double>(extent) + static_cast<double>(buffer)) {
+            vtzero_assert_in_noexcept_function(min_x < max_x && min_y < max_y);
+            if (m_min < std::numeric_limits<int32_t>::min()) {
+                m_min = std::numeric_limits<int32_t>::min();
+            }
+            if (m_max > std::numeric_limits<int32_t>::max()) {
+                m_max = std::numeric_limits<int32_t>::max();
+            }
+        }
+
+        /**
+         * Create a transformation for the specified tile in Web Mercator
+         * (EPSG:3857) coordinates.
+         *
+         * @param zoom Zoom level of the tile.
+         * @param x X coordinate of the tile.
+         * @param y Y coordinate of the tile (0 is the northernmost tile).
+         * @param extent Extent of the tile.
+         * @param buffer Buffer around the tile in tile coordinates.
+         *
+         * @pre @code zoom <= 32 @endcode
+         */
+        static tile_transform web_mercator(const uint32_t zoom, const uint32_t x, const uint32_t y,
+                                           const uint32_t extent = 4096, const uint32_t buffer = 0) noexcept {
+            static const double max_coordinate = 20037508.342789244;
+            const double size = 2.0 * max_coordinate / std::ldexp(1.0, static_cast<int>(zoom));
+            const double min_x = -max_coordinate + static_cast<double>(x) * size;
+            const double max_y = max_coordinate - static_cast<double>(y) * size;
+            return tile_transform{min_x, max_y - size, min_x + size, max_y, extent, buffer};
+        }
+
+        /**
+         * Transform the specified world coordinates into a point in tile
+         * coordinates.
+         */
+        point operator()(const double x, const double y) const noexcept {
+            return {static_cast<int32_t>(clamp((x - m_min_x) * m_scale_x)),
+                    static_cast<int32_t>(clamp((m_max_y - y) * m_scale_y))};
+        }
+
+    }; // class tile_transform
+
+    namespace detail {
+
+        /// The coordinates of a point, linestring, or ring in WKB.
+        struct wkb_coordinates {
+
+            const char* data = nullptr;
+            uint32_t count = 0;
+            uint32_t stride = 16;
+            bool little_endian = true;
+
+            wkb_coordinates() noexcept = default;
+
+            wkb_coordinates(const char* d, const uint32_t c, const uint32_t s, const bool le) noexcept :
+                data(d),
+                count(c),
+                stride(s),
+                little_endian(le) {
+            }
+
+            double get_double(const char* p) const noexcept {
+                uint64_t bits = 0;
+                for (int i = 0; i < 8; ++i) {
+                    const auto byte = static_cast<uint64_t>(static_cast<unsigned char>(p[little_endian ? 7 - i : i]));
+                    bits = (bits << 8U) | byte;
+                }
+                double value = 0.0;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+
+            point get(const uint32_t n, const tile_transform& transform) const noexcept {
+                const char* p = data + static_cast<std::size_t>(n) * stride;
+                return transform(get_double(p), get_double(p + 8));
+            }
+
+            bool is_empty_point() const noexcept {
+                return std::isnan(get_double(data)) || std::isnan(get_double(data + 8));
+            }
+
+            /**
+             * Call func for each transformed point in order (or in reverse
+             * order) skipping points which are the same as the point
+             * before.
+             */
+            template <typename TFunc>
+            void for_each_unique(const tile_transform& transform, const bool reverse, TFunc&& func) const {
+                point last;
+                for (uint32_t i = 0; i < count; ++i) {
+                    const point p = get(reverse ? count - 1 - i : i, transform);
+                    if (i == 0 || p != last) {
+                        std::forward<TFunc>(func)(p);
+                        last = p;
+                    }
+                }
+            }
+
+        }; // struct wkb_coordinates
+
+        /// The header of a (sub-)geometry in WKB.
+        struct wkb_header {
+            wkb_type type = wkb_type::point;
+            uint32_t dimensions = 2;
+            bool little_endian = true;
+        }; // struct wkb_header
+
+        /// Reads geometries in WKB (ISO WKB and EWKB) format.
+        class wkb_reader {
+
+            const char* m_data;
+            const char* m_end;
+
+            const char* skip(const std::size_t size) {
+                if (size > static_cast<std::size_t>(m_end - m_data)) {
+                    throw geometry_exception{"WKB too short"};
+                }
+                const char* p = m_data;
+                m_data += size;
+                return p;
+            }
+
+        public:
+
+            explicit wkb_reader(const data_view data) noexcept :
+                m_data(data.data()),
+                m_end(data.data() + data.size()) {
+            }
+
+            bool at_end() const noexcept {
+                return m_data == m_end;
+            }
+
+            uint32_t get_uint32(const bool little_endian) {
+                const char* p = skip(4);
+                uint32_t value = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const auto byte = static_cast<uint32_t>(static_cast<unsigned char>(p[little_endian ? 3 - i : i]));
+                    value = (value << 8U) | byte;
+                }
+                return value;
+            }
+
+            wkb_header get_header() {
+                wkb_header header;
+                const char byte_order = *skip(1);
+                if (byte_order != 0 && byte_order != 1) {
+                    throw geometry_exception{"unknown byte order in WKB"};
+                }
+                header.little_endian = byte_order == 1;
+
+                uint32_t type = get_uint32(header.little_endian);
+
+                // EWKB flags
+                if (type & 0x80000000U) {
+                    ++header.dimensions;
+                }
+                if (type & 0x40000000U) {
+                    ++header.dimensions;
+                }
+                if (type & ewkb_srid_flag) {
+                    skip(4);
+                }
+                type &= 0x0fffffffU;
+
+                // ISO WKB Z, M, and ZM types
+                if (type > 1000 && type < 4000) {
+                    header.dimensions += type / 1000 == 3 ? 2 : 1;
+                    type %= 1000;
+                }
+
+                if (type < static_cast<uint32_t>(wkb_type::point) ||
+                    type > static_cast<uint32_t>(wkb_type::multipolygon)) {
+                    throw geometry_exception{"unsupported geometry type in WKB: " + std::to_string(type)};
+                }
+                header.type = static_cast<wkb_type>(type);
+
+                return header;
+            }
+
+            wkb_header get_header(const wkb_type expected) {
+                const auto header = get_header();
+                if (header.type != expected) {
+                    throw geometry_exception{"unexpected geometry type in WKB"};
+                }
+                return header;
+            }
+
+            wkb_coordinates get_coordinates(const wkb_header& header, const uint32_t count) {
+                const uint32_t stride = header.dimensions * 8;
+                if (count > static_cast<std::size_t>(m_end - m_data) / stride) {
+                    throw geometry_exception{"WKB too short"};
+                }
+                return {skip(static_cast<std::size_t>(count) * stride), count, stride, header.little_endian};
+            }
+
+            wkb_coordinates get_coordinates(const wkb_header& header) {
+                return get_coordinates(header, get_uint32(header.little_endian));
+            }
+
+        }; // class wkb_reader
+
+        inline uint32_t check_wkb_num_points(const uint32_t count) {
+            if (count >= (1ul << 29u)) {
+                throw geometry_exception{"Maximum of 2^29 - 1 points allowed in geometry"};
+            }
+            return count;
+        }
+
+        inline uint32_t add_wkb_linestring(linestring_feature_builder& builder, const wkb_coordinates& coordinates, const tile_transform& transform) {
+            uint32_t count = 0;
+            coordinates.for_each_unique(transform, false, [&count](const point /*p*/) {
+                ++count;
+            });
+            if (count < 2) {
+                return 0;
+            }
+
+            builder.add_linestring(check_wkb_num_points(count));
+            coordinates.for_each_unique(transform, false, [&builder](const point p) {
+                builder.set_point(p);
+            });
+            return 1;
+        }
+
+        inline uint32_t add_wkb_ring(polygon_feature_builder& builder, const wkb_coordinates& coordinates, const tile_transform& transform, const bool outer) {
+            uint32_t count = 0;
+            int64_t sum = 0;
+            point first;
+            point last;
+            coordinates.for_each_unique(transform, false, [&](const point p) {
+                if (count == 0) {
+                    first = p;
+                } else {
+                    sum += det(last, p);
+                }
+                last = p;
+                ++count;
+            });
+            if (count == 0) {
+                return 0;
+            }
+
+            const bool closed = first == last;
+            if (!closed) {
+                sum += det(last, first);
+                ++count;
+            }
+            if (count < 4 || sum == 0) {
+                return 0;
+            }
+
+            // Outer rings must have a positive area in tile coordinates,
+            // inner rings a negative area. Fix the winding order by going
+            // through the points backwards if needed.
+            const bool reverse = outer ? (sum < 0) : (sum > 0);
+
+            builder.add_ring(check_wkb_num_points(count));
+            point start;
+            bool is_first = true;
+            coordinates.for_each_unique(transform, reverse, [&](const point p) {
+                if (is_first) {
+                    start = p;
+                    is_first = false;
+                }
+                builder.set_point(p);
+            });
+            if (!closed) {
+                builder.set_point(start);
+            }
+            return 1;
+        }
+
+        inline uint32_t add_wkb_polygon(polygon_feature_builder& builder, wkb_reader& reader, const wkb_header& header, const tile_transform& transform) {
+            const uint32_t num_rings = reader.get_uint32(header.little_endian);
+            uint32_t rings = 0;
+            bool has_outer = false;
+            for (uint32_t i = 0; i < num_rings; ++i) {
+                const auto coordinates = reader.get_coordinates(header);
+                // If the outer ring is degenerate, the holes are dropped, too.
+                if (i == 0) {
+                    has_outer = add_wkb_ring(builder, coordinates, transform, true) > 0;
+                    rings += has_outer ? 1 : 0;
+                } else if (has_outer) {
+                    rings += add_wkb_ring(builder, coordinates, transform, false);
+                }
+            }
+            return rings;
+        }
+
+    } // namespace detail
+
+    /**
+     * Get the type of the geometry in WKB.
+     *
+     * @param wkb The geometry in WKB or EWKB format.
+     * @returns GeomType::POINT for (Multi)Points, GeomType::LINESTRING for
+     *          (Multi)LineStrings, and GeomType::POLYGON for
+     *          (Multi)Polygons.
+     * @throws geometry_exception if the WKB is invalid or contains some
+     *         other geometry type.
+     */
+    inline GeomType wkb_geometry_type(const data_view wkb) {
+        detail::wkb_reader reader{wkb};
+        switch (reader.get_header().type) {
+            case wkb_type::point:
+            case wkb_type::multipoint:
+                return GeomType::POINT;
+            case wkb_type::linestring:
+            case wkb_type::multilinestring:
+                return GeomType::LINESTRING;
+            default:
+                break;
+        }
+        return GeomType::POLYGON;
+    }
+
+    /**
+     * Add a Point or MultiPoint geometry in WKB format to the builder.
+     * The points are transformed into tile coordinates. Consecutive
+     * points which end up being the same are only added once, empty points
+     * are ignored. The WKB is read straight into the builder, nothing is
+     * copied.
+     *
+     * @param builder The feature builder.
+     * @param wkb The geometry in WKB or EWKB format. Z and M coordinates
+     *        are ignored.
+     * @param transform The transformation into tile coordinates.
+     * @returns The number of points added. If this is 0, no geometry was
+     *          added and the feature should be rolled back.
+     * @throws geometry_exception if the WKB is invalid or doesn't contain a
+     *         Point or MultiPoint.
+     *
+     * @pre You must not have added a geometry or any properties to the
+     *      builder.
+     */
+    inline uint32_t add_geometry_from_wkb(point_feature_builder& builder, const data_view wkb, const tile_transform& transform) {
+        detail::wkb_reader reader{wkb};
+        const auto header = reader.get_header();
+
+        if (header.type == wkb_type::point) {
+            const auto coordinates = reader.get_coordinates(header, 1);
+            if (coordinates.is_empty_point()) {
+                return 0;
+            }
+            builder.add_point(coordinates.get(0, transform));
+            return 1;
+        }
+
+        if (header.type != wkb_type::multipoint) {
+            throw geometry_exception{"expected Point or MultiPoint in WKB"};
+        }
+
+        // Points in a MultiPoint are complete geometries with their own
+        // header, so they are read twice: once for counting and once
+        // for adding them.
+        const uint32_t num_points = reader.get_uint32(header.little_endian);
+        const detail::wkb_reader start = reader;
+
+        uint32_t count = 0;
+        point last;
+        for (uint32_t i = 0; i < num_points; ++i) {
+            const auto coordinates = reader.get_coordinates(reader.get_header(wkb_type::point), 1);
+            if (!coordinates.is_empty_point()) {
+                const auto p = coordinates.get(0, transform);
+                if (count == 0 || p != last) {
+                    ++count;
+                    last = p;
+                }
+            }
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        builder.add_points(detail::check_wkb_num_points(count));
+        reader = start;
+        bool first = true;
+        for (uint32_t i = 0; i < num_points; ++i) {
+            const auto coordinates = reader.get_coordinates(reader.get_header(), 1);
+            if (!coordinates.is_empty_point()) {
+                const auto p = coordinates.get(0, transform);
+                if (first || p != last) {
+                    builder.set_point(p);
+                    last = p;
+                    first = false;
+                }
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Add a LineString or MultiLineString geometry in WKB format to the
+     * builder. The points are transformed into tile coordinates.
+     * Consecutive points which end up being the same are only added once,
+     * linestrings with less than two points left are dropped. The WKB is
+     * read straight into the builder, nothing is copied.
+     *
+     * @param builder The feature builder.
+     * @param wkb The geometry in WKB or EWKB format. Z and M coordinates
+     *        are ignored.
+     * @param transform The transformation into tile coordinates.
+     * @returns The number of linestrings added. If this is 0, no geometry
+     *          was added and the feature should be rolled back.
+     * @throws geometry_exception if the WKB is invalid or doesn't contain a
+     *         LineString or MultiLineString.
+     *
+     * @pre You must not have added a geometry or any properties to the
+     *      builder.
+     */
+    inline uint32_t add_geometry_from_wkb(linestring_feature_builder& builder, const data_view wkb, const tile_transform& transform) {
+        detail::wkb_reader reader{wkb};
+        const auto header = reader.get_header();
+
+        if (header.type == wkb_type::linestring) {
+            return detail::add_wkb_linestring(builder, reader.get_coordinates(header), transform);
+        }
+
+        if (header.type != wkb_type::multilinestring) {
+            throw geometry_exception{"expected LineString or MultiLineString in WKB"};
+        }
+
+        const uint32_t num_linestrings = reader.get_uint32(header.little_endian);
+        uint32_t linestrings = 0;
+        for (uint32_t i = 0; i < num_linestrings; ++i) {
+            const auto coordinates = reader.get_coordinates(reader.get_header(wkb_type::linestring));
+            linestrings += detail::add_wkb_linestring(builder, coordinates, transform);
+        }
+        return linestrings;
+    }
+
+    /**
+     * Add a Polygon or MultiPolygon geometry in WKB format to the builder.
+     * The points are transformed into tile coordinates. Consecutive points
+     * which end up being the same are only added once, rings which are
+     * not closed are closed. The winding order of the rings is fixed if
+     * needed. Rings with less than four points or without area are
+     * dropped, if the outer ring of a polygon is dropped, its inner rings
+     * are dropped, too. The WKB is read straight into the builder, nothing
+     * is copied.
+     *
+     * @param builder The feature builder.
+     * @param wkb The geometry in WKB or EWKB format. Z and M coordinates
+     *        are ignored.
+     * @param transform The transformation into tile coordinates.
+     * @returns The number of rings added. If this is 0, no geometry was
+     *          added and the feature should be rolled back.
+     * @throws geometry_exception if the WKB is invalid or doesn't contain a
+     *         Polygon or MultiPolygon.
+     *
+     * @pre You must not have added a geometry or any properties to the
+     *      builder.
+     */
+    inline uint32_t add_geometry_from_wkb(polygon_feature_builder& builder, const data_view wkb, const tile_transform& transform) {
+        detail::wkb_reader reader{wkb};
+        const auto header = reader.get_header();
+
+        if (header.type == wkb_type::polygon) {
+            return detail::add_wkb_polygon(builder, reader, header, transform);
+        }
+
+        if (header.type != wkb_type::multipolygon) {
+            throw geometry_exception{"expected Polygon or MultiPolygon in WKB"};
+        }
+
+        const uint32_t num_polygons = reader.get_uint32(header.little_endian);
+        uint32_t rings = 0;
+        for (uint32_t i = 0; i < num_polygons; ++i) {
+            rings += detail::add_wkb_polygon(builder, reader, reader.get_header(wkb_type::polygon), transform);
+        }
+        return rings;
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_WKB_IMPORT_HPP
@@ -0,0 +1,381 @@
+
+// Tests checking how many memory allocations vtzero does. This is a
+// separate program, because it replaces the global operator new.
+
+#include <test.hpp>
+
+#include <vtzero/buffer_pool.hpp>
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/property_mapper.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+    std::size_t allocation_count = 0;
+    std::size_t allocation_bytes = 0;
+
+    // Counts the allocations and allocated bytes between construction and
+    // the calls to count() and bytes(). Catch might allocate, so the tests
+    // read the counts into local variables before using REQUIRE.
+    class allocation_counter {
+
+        std::size_t m_count;
+        std::size_t m_bytes;
+
+    public:
+
+        allocation_counter() noexcept :
+            m_count(allocation_count),
+            m_bytes(allocation_bytes) {
+        }
+
+        std::size_t count() const noexcept {
+            return allocation_count - m_count;
+        }
+
+        std::size_t bytes() const noexcept {
+            return allocation_bytes - m_bytes;
+        }
+
+    }; // class allocation_counter
+
+    struct null_handler {
+
+        void points_begin(const uint32_t /*count*/) const noexcept {
+        }
+
+        void points_point(const vtzero::point /*point*/) const noexcept {
+        }
+
+        void points_end() const noexcept {
+        }
+
+        void linestring_begin(const uint32_t /*count*/) const noexcept {
+        }
+
+        void linestring_point(const vtzero::point /*point*/) const noexcept {
+        }
+
+        void linestring_end() const noexcept {
+        }
+
+        void ring_begin(const uint32_t /*count*/) const noexcept {
+        }
+
+        void ring_point(const vtzero::point /*point*/) const noexcept {
+        }
+
+        void ring_end(const vtzero::ring_type /*type*/) const noexcept {
+        }
+
+    }; // struct null_handler
+
+} // anonymous namespace
+
+// GCC sees the free() in the replaced operator delete after inlining and
+// thinks it doesn't match the new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        throw std::bad_alloc{};
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic pop
+#endif
+
+TEST_CASE("Allocation counter works") {
+    allocation_counter counter;
+    std::string* str = new std::string{};
+    const auto count = counter.count();
+    const auto bytes = counter.bytes();
+    delete str;
+
+    REQUIRE(count == 1);
+    REQUIRE(bytes == sizeof(std::string));
+}
+
+TEST_CASE("Iterating over layers doesn't allocate") {
+    const auto data = load_test_tile();
+
+    allocation_counter counter;
+    vtzero::vector_tile tile{data};
+
+    std::size_t num = 0;
+    tile.for_each_layer([&](vtzero::layer&& /*layer*/) {
+        ++num;
+        return true;
+    });
+
+    while (tile.next_layer()) {
+        ++num;
+    }
+
+    const bool found = tile.get_layer_by_name("water") && tile.get_layer(3);
+    num += tile.count_layers();
+
+    const auto count = counter.count();
+    REQUIRE(found);
+    REQUIRE(num == 3 * tile.count_layers());
+    REQUIRE(count == 0);
+}
+
+TEST_CASE("Iterating over features doesn't allocate") {
+    const auto data = load_test_tile();
+
+    allocation_counter counter;
+    vtzero::vector_tile tile{data};
+
+    std::size_t num = 0;
+    while (auto layer = tile.next_layer()) {
+        layer.for_each_feature([&](vtzero::feature&& feature) {
+            num += static_cast<std::size_t>(feature.has_id());
+            return true;
+        });
+        while (auto feature = layer.next_feature()) {
+            while (feature.next_property_indexes()) {
+                ++num;
+            }
+        }
+    }
+
+    const auto count = counter.count();
+    REQUIRE(num > 0);
+    REQUIRE(count == 0);
+}
+
+TEST_CASE("Decoding geometries doesn't allocate") {
+    const auto data = load_test_tile();
+
+    allocation_counter counter;
+    vtzero::vector_tile tile{data};
+
+    std::size_t num = 0;
+    while (auto layer = tile.next_layer()) {
+        while (auto feature = layer.next_feature()) {
+            vtzero::decode_geometry(feature.geometry(), null_handler{});
+            ++num;
+        }
+    }
+
+    const auto count = counter.count();
+    REQUIRE(num > 0);
+    REQUIRE(count == 0);
+}
+
+TEST_CASE("Reading properties only allocates the tables once per layer") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    allocation_counter counter;
+
+    std::size_t num_layers = 0;
+    std::size_t table_bytes = 0;
+    while (auto layer = tile.next_layer()) {
+        ++num_layers;
+        table_bytes += layer.key_table().size() * sizeof(vtzero::data_view) +
+                       layer.value_table().size() * sizeof(vtzero::property_value);
+        while (auto feature = layer.next_feature()) {
+            while (feature.next_property()) {
+            }
+            feature.for_each_property([](const vtzero::property& /*property*/) {
+                return true;
+            });
+        }
+    }
+
+    const auto count = counter.count();
+    const auto bytes = counter.bytes();
+
+    // one allocation for the key table and one for the value table
+    REQUIRE(count <= 2 * num_layers);
+    REQUIRE(bytes == table_bytes);
+}
+
+TEST_CASE("Layer builders only allocate hash table slots when they use them") {
+    vtzero::tile_builder tbuilder;
+
+    allocation_counter counter;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    lbuilder.set_table_index_policy(vtzero::table_index_policy::small_table);
+    const auto count = counter.count();
+
+    allocation_counter small_counter;
+    lbuilder.add_key("key");
+    lbuilder.add_value(vtzero::encoded_property_value{"value"});
+    lbuilder.add_key("key");
+    lbuilder.add_value(vtzero::encoded_property_value{"value"});
+    const auto small_count = small_counter.count();
+
+    vtzero::layer_builder flat_lbuilder{tbuilder, "flat"};
+    flat_lbuilder.set_table_index_policy(vtzero::table_index_policy::flat_hash);
+
+    allocation_counter flat_counter;
+    flat_lbuilder.add_key("key");
+    flat_lbuilder.add_value(vtzero::encoded_property_value{"value"});
+    flat_lbuilder.add_key("key");
+    flat_lbuilder.add_value(vtzero::encoded_property_value{"value"});
+    const auto flat_count = flat_counter.count();
+
+    // the layer builder itself and the list of layers in the tile builder
+    REQUIRE(count == 2);
+
+    // hash, offset, and size of the entry in the key and value table
+    // (the first entry is only indexed when the table is searched again)
+    REQUIRE(small_count == 6);
+
+    // the slots of the key and value table
+    REQUIRE(flat_count == 2);
+}
+
+// Build a layer with the specified number of features and return the
+// number of allocations needed for the whole tile.
+static std::size_t build_features(const int num_features) {
+    allocation_counter counter;
+    {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+        for (int n = 0; n < num_features; ++n) {
+            vtzero::linestring_feature_builder fbuilder{lbuilder};
+            fbuilder.set_id(static_cast<uint64_t>(n));
+            fbuilder.add_linestring(3);
+            fbuilder.set_point(n, 1);
+            fbuilder.set_point(n, 2);
+            fbuilder.set_point(n, 3);
+            fbuilder.add_property("type", "road");
+            fbuilder.add_property("lanes", n % 4);
+            fbuilder.commit();
+        }
+
+        tbuilder.serialize();
+    }
+    return counter.count();
+}
+
+TEST_CASE("Building features only allocates for growing buffers") {
+    const auto count = build_features(10000);
+    const auto count_double = build_features(20000);
+
+    // Doubling the number of features only makes the data buffer of the
+    // layer and the serialized tile grow one more time.
+    REQUIRE(count_double <= count + 2);
+}
+
+// Copy all features of the tile (each of them the specified number of
+// times) using a property_mapper and return the number of allocations
+// needed for the whole tile.
+static std::size_t copy_features(vtzero::vector_tile tile, const int copies) {
+    allocation_counter counter;
+    {
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            vtzero::property_mapper mapper{layer, lbuilder};
+            while (auto feature = layer.next_feature()) {
+                for (int n = 0; n < copies; ++n) {
+                    lbuilder.add_feature(feature, mapper);
+                }
+            }
+        }
+        tbuilder.serialize();
+    }
+    return counter.count();
+}
+
+TEST_CASE("Copying features with property_mapper only allocates for growing buffers") {
+    const auto data = load_test_tile();
+    const vtzero::vector_tile tile{data};
+    const auto num_layers = tile.count_layers();
+
+    const auto count = copy_features(tile, 1);
+    const auto count_double = copy_features(tile, 2);
+
+    // Copying each feature twice only makes the data buffer of each layer
+    // and the serialized tile grow one more time.
+    REQUIRE(count_double <= count + num_layers + 1);
+}
+
+TEST_CASE("Building tiles with a buffer pool hardly allocates") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    const auto num_layers = tile.count_layers();
+
+    vtzero::buffer_pool pool;
+    std::string output;
+
+    auto build_tile = [&]() {
+        tile.reset_layer();
+        vtzero::tile_builder tbuilder{pool};
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            while (auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature);
+            }
+        }
+        output.clear();
+        tbuilder.serialize(output);
+    };
+
+    allocation_counter first_counter;
+    build_tile();
+    const auto first_count = first_counter.count();
+
+    // The pool hands out the buffers and indexes in reverse order, so it
+    // takes two tiles until all of them are large enough for every layer.
+    build_tile();
+
+    allocation_counter counter;
+    build_tile();
+    const auto count = counter.count();
+
+    allocation_counter next_counter;
+    build_tile();
+    const auto next_count = next_counter.count();
+
+    // Without the pool the data, the key and value tables, and the
+    // indexes of each layer are allocated and grow several times.
+    REQUIRE(count < first_count);
+
+    // Per layer: the layer builder and the key and value tables of the
+    // source layer. Plus the growing list of layers in the tile builder.
+    REQUIRE(count <= 3 * num_layers + 8);
+    REQUIRE(next_count == count);
+    REQUIRE(output.size() > 0);
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+
+  Common code for the vtzero fuzzers.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+
+    // The fuzzers are single-threaded, so there is no need for an atomic.
+    std::size_t allocation_bytes = 0;
+
+    // Small inputs are always allowed this much memory and time.
+    constexpr const std::size_t base_alloc = 64 * 1024;
+    constexpr const double base_ns = 10.0 * 1000 * 1000;
+
+    std::size_t env_limit(const char* name, const std::size_t default_value) noexcept {
+        const char* value = std::getenv(name);
+        if (value == nullptr) {
+            return default_value;
+        }
+        return static_cast<std::size_t>(std::strtoull(value, nullptr, 10));
+    }
+
+} // anonymous namespace
+
+// GCC sees the free() in the replaced operator delete after inlining and
+// thinks it doesn't match the new.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocation_bytes += size;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) {
+        throw std::bad_alloc{};
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+# pragma GCC diagnostic pop
+#endif
+
+namespace fuzz {
+
+    std::size_t allocated_bytes() noexcept {
+        return allocation_bytes;
+    }
+
+    cost_tracker::cost_tracker(const char* name, const std::size_t input_size) noexcept :
+        m_name(name),
+        m_input_size(input_size),
+        m_allocated_bytes(allocation_bytes),
+        m_start(std::chrono::steady_clock::now()) {
+    }
+
+    cost_tracker::~cost_tracker() noexcept {
+        const auto end = std::chrono::steady_clock::now();
+        const auto alloc = allocation_bytes - m_allocated_bytes;
+        const double ns = std::chrono::duration<double, std::nano>(end - m_start).count();
+
+        static const std::size_t max_alloc_per_byte = env_limit("VTZERO_FUZZ_MAX_ALLOC_PER_BYTE", 64);
+        static const std::size_t max_ns_per_byte = env_limit("VTZERO_FUZZ_MAX_NS_PER_BYTE", 0);
+
+        bool too_expensive = false;
+        if (max_alloc_per_byte > 0 && alloc > base_alloc + max_alloc_per_byte * m_input_size) {
+            too_expensive = true;
+        }
+        if (max_ns_per_byte > 0 && ns > base_ns + static_cast<double>(max_ns_per_byte * m_input_size)) {
+            too_expensive = true;
+        }
+
+        if (too_expensive) {
+            const double size = m_input_size > 0 ? static_cast<double>(m_input_size) : 1.0;
+            std::cerr << "vtzero fuzzer " << m_name << ": input too expensive: "
+                      << m_input_size << " bytes, "
+                      << alloc << " bytes allocated (" << (static_cast<double>(alloc) / size) << " per byte), "
+                      << static_cast<uint64_t>(ns) << " ns (" << (ns / size) << " per byte)\n";
+            std::abort();
+        }
+    }
+
+} // namespace fuzz
+
@@ -0,0 +1,158 @@
+#ifndef FUZZ_COMMON_HPP
+#define FUZZ_COMMON_HPP
+
+/*****************************************************************************
+
+  Common code for the vtzero fuzzers.
+
+  Besides crashes and sanitizer errors the fuzzers report inputs which are
+  too expensive to process compared to their size. The costs tracked are
+  the time needed and the memory allocated per input byte. The limits can
+  be set with the environment variables
+
+  VTZERO_FUZZ_MAX_ALLOC_PER_BYTE - Maximum number of bytes allocated per
+                                   input byte (default: 64).
+  VTZERO_FUZZ_MAX_NS_PER_BYTE    - Maximum time in nanoseconds needed per
+                                   input byte (default: 0 = no limit, because
+                                   timings depend on the machine and on the
+                                   sanitizers used).
+
+  A small constant amount of memory and time is always allowed so that tiny
+  inputs are not reported.
+
+*****************************************************************************/
+
+#include <vtzero/geometry.hpp>
+#include <vtzero/layer.hpp>
+#include <vtzero/property_value.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fuzz {
+
+    /// Number of bytes allocated through operator new so far.
+    std::size_t allocated_bytes() noexcept;
+
+    /**
+     * Tracks the cost of processing one input. The destructor checks the
+     * cost against the limits and aborts the program (which makes the
+     * fuzzer save the input) if it is too high.
+     */
+    class cost_tracker {
+
+        const char* m_name;
+        std::size_t m_input_size;
+        std::size_t m_allocated_bytes;
+        std::chrono::steady_clock::time_point m_start;
+
+    public:
+
+        cost_tracker(const char* name, std::size_t input_size) noexcept;
+
+        ~cost_tracker() noexcept;
+
+        cost_tracker(const cost_tracker&) = delete;
+        cost_tracker& operator=(const cost_tracker&) = delete;
+
+        cost_tracker(cost_tracker&&) = delete;
+        cost_tracker& operator=(cost_tracker&&) = delete;
+
+    }; // class cost_tracker
+
+    /**
+     * Geometry handler that reserves space for the points of each part of
+     * the geometry as announced by the counts in the geometry like a
+     * typical handler does and then stores the points.
+     */
+    struct geometry_handler {
+
+        std::vector<vtzero::point> points;
+
+        void points_begin(const uint32_t count) {
+            points.clear();
+            points.reserve(count);
+        }
+
+        void points_point(const vtzero::point point) {
+            points.push_back(point);
+        }
+
+        void points_end() const noexcept {
+        }
+
+        void linestring_begin(const uint32_t count) {
+            points.clear();
+            points.reserve(count);
+        }
+
+        void linestring_point(const vtzero::point point) {
+            points.push_back(point);
+        }
+
+        void linestring_end() const noexcept {
+        }
+
+        void ring_begin(const uint32_t count) {
+            points.clear();
+            points.reserve(count);
+        }
+
+        void ring_point(const vtzero::point point) {
+            points.push_back(point);
+        }
+
+        void ring_end(const vtzero::ring_type /*type*/) const noexcept {
+        }
+
+    }; // struct geometry_handler
+
+    /**
+     * Visitor used for reading all property values.
+     */
+    struct value_visitor {
+
+        template <typename T>
+        std::size_t operator()(T value) const noexcept {
+            return static_cast<std::size_t>(value != T{});
+        }
+
+        std::size_t operator()(const vtzero::data_view value) const noexcept {
+            return value.size();
+        }
+
+    }; // struct value_visitor
+
+    /// Read everything in a feature.
+    inline std::size_t read_feature(const vtzero::feature& feature) {
+        std::size_t sum = feature.id();
+
+        feature.for_each_property([&sum](const vtzero::property& property) {
+            sum += property.key().size() + vtzero::apply_visitor(value_visitor{}, property.value());
+            return true;
+        });
+
+        geometry_handler handler;
+        vtzero::decode_geometry(feature.geometry(), handler);
+        sum += handler.points.size();
+
+        return sum;
+    }
+
+    /// Read everything in a layer.
+    inline std::size_t read_layer(vtzero::layer& layer) {
+        std::size_t sum = layer.name().size() + layer.version() + layer.extent();
+        sum += layer.key_table().size() + layer.value_table().size();
+
+        while (const auto feature = layer.next_feature()) {
+            sum += read_feature(feature);
+        }
+
+        return sum;
+    }
+
+} // namespace fuzz
+
+#endif // FUZZ_COMMON_HPP
@@ -0,0 +1,55 @@
+/*****************************************************************************
+
+  Fuzzer for reading a feature. The feature is read in the context of a
+  fixed layer with a few keys and values.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <vtzero/builder.hpp>
+#include <vtzero/layer.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <protozero/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+static std::string create_layer_data() {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    lbuilder.add_key("a");
+    lbuilder.add_key("b");
+    lbuilder.add_value(vtzero::encoded_property_value{"x"});
+    lbuilder.add_value(vtzero::encoded_property_value{1});
+    lbuilder.add_value(vtzero::encoded_property_value{1.5});
+
+    // empty layers are not serialized
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(1, 1);
+    fbuilder.commit();
+
+    const auto tile_data = tbuilder.serialize();
+    vtzero::vector_tile tile{tile_data};
+    const auto layer = tile.next_layer();
+    return std::string(layer.data().data(), layer.data().size());
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    static const std::string layer_data = create_layer_data();
+    static const vtzero::layer layer{vtzero::data_view{layer_data.data(), layer_data.size()}};
+
+    fuzz::cost_tracker tracker{"feature", size};
+
+    try {
+        const vtzero::feature feature{&layer, vtzero::data_view{reinterpret_cast<const char*>(data), size}};
+        fuzz::read_feature(feature);
+    } catch (const vtzero::exception&) {
+    } catch (const protozero::exception&) {
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,36 @@
+/*****************************************************************************
+
+  Fuzzer for decoding geometries. The first byte of the input is the
+  geometry type, the rest is the encoded geometry.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <vtzero/geometry.hpp>
+
+#include <protozero/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    fuzz::cost_tracker tracker{"geometry", size};
+
+    const auto type = static_cast<vtzero::GeomType>(data[0] % 4);
+    const vtzero::geometry geometry{vtzero::data_view{reinterpret_cast<const char*>(data) + 1, size - 1}, type};
+
+    try {
+        fuzz::geometry_handler handler;
+        vtzero::decode_geometry(geometry, handler);
+    } catch (const vtzero::exception&) {
+    } catch (const protozero::exception&) {
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,29 @@
+/*****************************************************************************
+
+  Fuzzer for reading a layer.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <vtzero/layer.hpp>
+
+#include <protozero/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    fuzz::cost_tracker tracker{"layer", size};
+
+    try {
+        vtzero::layer layer{vtzero::data_view{reinterpret_cast<const char*>(data), size}};
+        fuzz::read_layer(layer);
+        layer.get_feature_by_id(1);
+    } catch (const vtzero::exception&) {
+    } catch (const protozero::exception&) {
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,42 @@
+/*****************************************************************************
+
+  Driver for running the fuzzers without libFuzzer, for instance with AFL
+  or on a corpus of test files. Calls the fuzzer once with the contents of
+  each file given on the command line (or with STDIN if there are none).
+
+*****************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size);
+
+static void run(const std::string& input) {
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        run(std::string{std::istreambuf_iterator<char>(std::cin.rdbuf()),
+                        std::istreambuf_iterator<char>()});
+        return 0;
+    }
+
+    for (int n = 1; n < argc; ++n) {
+        std::ifstream stream{argv[n], std::ios_base::in | std::ios_base::binary};
+        if (!stream) {
+            std::cerr << "Can not open file '" << argv[n] << "'\n";
+            return 1;
+        }
+        run(std::string{std::istreambuf_iterator<char>(stream.rdbuf()),
+                        std::istreambuf_iterator<char>()});
+    }
+
+    std::cout << "Ran " << (argc - 1) << " inputs\n";
+    return 0;
+}
+
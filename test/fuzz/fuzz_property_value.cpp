@@ -0,0 +1,28 @@
+/*****************************************************************************
+
+  Fuzzer for decoding property values.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <vtzero/property_value.hpp>
+
+#include <protozero/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    fuzz::cost_tracker tracker{"property_value", size};
+
+    try {
+        const vtzero::property_value value{vtzero::data_view{reinterpret_cast<const char*>(data), size}};
+        vtzero::apply_visitor(fuzz::value_visitor{}, value);
+    } catch (const vtzero::exception&) {
+    } catch (const protozero::exception&) {
+    }
+
+    return 0;
+}
+
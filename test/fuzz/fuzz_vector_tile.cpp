@@ -0,0 +1,32 @@
+/*****************************************************************************
+
+  Fuzzer for reading complete vector tiles.
+
+*****************************************************************************/
+
+#include "fuzz_common.hpp"
+
+#include <vtzero/vector_tile.hpp>
+
+#include <protozero/exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, std::size_t size) {
+    fuzz::cost_tracker tracker{"vector_tile", size};
+
+    try {
+        vtzero::vector_tile tile{reinterpret_cast<const char*>(data), size};
+        tile.count_layers();
+        tile.get_layer_by_name("water");
+        while (auto layer = tile.next_layer()) {
+            fuzz::read_layer(layer);
+        }
+    } catch (const vtzero::exception&) {
+    } catch (const protozero::exception&) {
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,156 @@
+
+// This is compiled with VTZERO_STATS defined (see CMakeLists.txt).
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+
+struct point_handler {
+
+    void points_begin(const uint32_t /*count*/) const noexcept {
+    }
+
+    void points_point(const vtzero::point /*point*/) const noexcept {
+    }
+
+    void points_end() const noexcept {
+    }
+
+}; // struct point_handler
+
+TEST_CASE("Stats are counted in the current thread") {
+    vtzero::thread_stats().clear();
+    REQUIRE(vtzero::thread_stats().tiles == 0);
+
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    const auto& stats = vtzero::thread_stats();
+    REQUIRE(stats.tiles == 1);
+    REQUIRE(stats.tile_bytes == data.size());
+
+    vtzero::thread_stats().clear();
+    REQUIRE(stats.tiles == 0);
+    REQUIRE(stats.tile_bytes == 0);
+}
+
+TEST_CASE("Stats for decoding layers and features") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    vtzero::thread_stats().clear();
+    const auto& stats = vtzero::thread_stats();
+
+    uint64_t num_features = 0;
+    while (auto layer = tile.next_layer()) {
+        num_features += layer.num_features();
+        while (layer.next_feature()) {
+        }
+    }
+
+    REQUIRE(stats.layers == tile.count_layers());
+    REQUIRE(stats.features == num_features);
+    REQUIRE(stats.properties == 0);
+    REQUIRE(stats.table_initializations == 0);
+    REQUIRE(stats.geometries == 0);
+}
+
+TEST_CASE("Stats for decoding properties") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.get_layer_by_name("bridge");
+    REQUIRE(layer);
+    auto feature = layer.next_feature();
+    REQUIRE(feature);
+
+    vtzero::thread_stats().clear();
+    const auto& stats = vtzero::thread_stats();
+
+    const auto num_properties = feature.num_properties();
+    REQUIRE(num_properties > 0);
+
+    while (feature.next_property()) {
+    }
+    REQUIRE(stats.properties == num_properties);
+    REQUIRE(stats.varints == 2 * num_properties);
+    REQUIRE(stats.table_initializations == 1);
+    REQUIRE(stats.table_entries == layer.key_table().size() + layer.value_table().size());
+    REQUIRE(stats.table_lookups == 2 * num_properties);
+
+    feature.for_each_property([](const vtzero::property& /*property*/) {
+        return true;
+    });
+    REQUIRE(stats.properties == 2 * num_properties);
+    REQUIRE(stats.table_initializations == 1);
+}
+
+TEST_CASE("Stats for decoding geometries") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.get_layer_by_name("place_label");
+    REQUIRE(layer);
+    auto feature = layer.next_feature();
+    REQUIRE(feature);
+    REQUIRE(feature.geometry_type() == vtzero::GeomType::POINT);
+
+    vtzero::thread_stats().clear();
+    const auto& stats = vtzero::thread_stats();
+
+    vtzero::decode_point_geometry(feature.geometry(), point_handler{});
+    REQUIRE(stats.geometries == 1);
+    REQUIRE(stats.geometry_commands == 1);
+    REQUIRE(stats.geometry_points == 1);
+    REQUIRE(stats.varints == 3);
+}
+
+TEST_CASE("Stats for building tiles") {
+    vtzero::thread_stats().clear();
+    const auto& stats = vtzero::thread_stats();
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    for (int n = 0; n < 3; ++n) {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("foo", "bar");
+        fbuilder.add_property("x", n);
+        if (n == 2) {
+            fbuilder.rollback();
+        } else {
+            fbuilder.commit();
+        }
+    }
+
+    REQUIRE(stats.features_committed == 2);
+    REQUIRE(stats.features_rolled_back == 1);
+    REQUIRE(stats.key_dedup_misses == 2);
+    REQUIRE(stats.key_dedup_hits == 4);
+    REQUIRE(stats.value_dedup_misses == 4);
+    REQUIRE(stats.value_dedup_hits == 2);
+    REQUIRE(stats.index_promotions == 0);
+
+    const auto tile = tbuilder.serialize();
+    REQUIRE(stats.tiles_serialized == 1);
+    REQUIRE(stats.serialized_bytes == tile.size());
+}
+
+TEST_CASE("Stats count index promotions") {
+    vtzero::thread_stats().clear();
+    const auto& stats = vtzero::thread_stats();
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    for (int n = 0; n < 100; ++n) {
+        lbuilder.add_key(std::to_string(n));
+    }
+
+    REQUIRE(stats.key_dedup_misses == 100);
+    REQUIRE(stats.index_promotions == 1);
+}
+
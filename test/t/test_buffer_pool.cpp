@@ -0,0 +1,78 @@
+
+#include <test.hpp>
+
+#include <vtzero/buffer_pool.hpp>
+#include <vtzero/builder.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+
+static std::string build_tile(vtzero::tile_builder& tbuilder) {
+    for (const char* name : {"a", "b"}) {
+        vtzero::layer_builder lbuilder{tbuilder, name};
+        for (int n = 0; n < 100; ++n) {
+            vtzero::point_feature_builder fbuilder{lbuilder};
+            fbuilder.set_id(static_cast<uint64_t>(n));
+            fbuilder.add_point(n, n);
+            fbuilder.add_property("n", n);
+            fbuilder.commit();
+        }
+    }
+    return tbuilder.serialize();
+}
+
+TEST_CASE("buffer pool") {
+    vtzero::buffer_pool pool{4};
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.capacity() == 0);
+
+    std::string expected;
+    {
+        vtzero::tile_builder tbuilder;
+        expected = build_tile(tbuilder);
+    }
+
+    {
+        vtzero::tile_builder tbuilder{pool};
+        REQUIRE(build_tile(tbuilder) == expected);
+    }
+
+    // two layers with three buffers each, but only four are kept
+    REQUIRE(pool.size() == 4);
+    const auto capacity = pool.capacity();
+    REQUIRE(capacity > 0);
+
+    {
+        vtzero::tile_builder tbuilder{pool};
+        REQUIRE(build_tile(tbuilder) == expected);
+        REQUIRE(pool.size() == 0);
+    }
+
+    REQUIRE(pool.size() == 4);
+    REQUIRE(pool.capacity() >= capacity);
+
+    pool.clear();
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.capacity() == 0);
+}
+
+TEST_CASE("buffer pool with maximum buffer size") {
+    vtzero::buffer_pool pool{10, 16};
+
+    std::string buffer(100, 'x');
+    pool.release(buffer);
+    REQUIRE(buffer.empty());
+    REQUIRE(pool.size() == 0);
+
+    buffer = "abc";
+    buffer.shrink_to_fit();
+    pool.release(buffer);
+    REQUIRE(buffer.empty());
+    REQUIRE(pool.size() == 1);
+
+    std::string other;
+    pool.acquire(other);
+    REQUIRE(other.empty());
+    REQUIRE(other.capacity() > 0);
+    REQUIRE(pool.size() == 0);
+}
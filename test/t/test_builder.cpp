@@ -3,11 +3,15 @@
 
 #include <vtzero/builder.hpp>
 #include <vtzero/index.hpp>
+#include <vtzero/layer_fragment.hpp>
 #include <vtzero/output.hpp>
+#include <vtzero/property_mapper.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 template <typename T>
 struct movable_not_copyable {
@@ -306,6 +310,83 @@ TEST_CASE("Copy tile") {
     REQUIRE(vector_tile_equal(buffer, data));
 }
 
+TEST_CASE("Copied feature is in serialized tile") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+    auto layer = tile.get_layer_by_name("place_label");
+    REQUIRE(layer);
+    const auto feature = layer.next_feature();
+    REQUIRE(feature);
+
+    vtzero::tile_builder tbuilder;
+    {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        lbuilder.add_feature(feature);
+    }
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile new_tile{data};
+    auto new_layer = new_tile.next_layer();
+    REQUIRE(new_layer);
+    REQUIRE(new_layer.name() == "place_label");
+    REQUIRE(new_layer.num_features() == 1);
+
+    const auto new_feature = new_layer.next_feature();
+    REQUIRE(new_feature.id() == feature.id());
+    REQUIRE(new_feature.geometry().data() == feature.geometry().data());
+    REQUIRE(new_feature.num_properties() == feature.num_properties());
+}
+
+TEST_CASE("Copy tile using property_mapper") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        vtzero::property_mapper mapper{layer, lbuilder};
+        while (auto feature = layer.next_feature()) {
+            // add_feature() must copy all properties even if some were read
+            // already
+            feature.next_property_indexes();
+            lbuilder.add_feature(feature, mapper);
+        }
+    }
+
+    const std::string data = tbuilder.serialize();
+    REQUIRE(vector_tile_equal(buffer, data));
+}
+
+TEST_CASE("Copy some features using property_mapper only adds needed keys and values") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+    auto layer = tile.get_layer_by_name("place_label");
+    REQUIRE(layer);
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, layer};
+    vtzero::property_mapper mapper{layer, lbuilder};
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature);
+    const auto num_properties = feature.num_properties();
+    lbuilder.add_feature(feature, mapper);
+    lbuilder.add_feature(feature, mapper);
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile result_tile{data};
+    auto result_layer = result_tile.next_layer();
+    REQUIRE(result_layer);
+    REQUIRE(result_layer.num_features() == 2);
+    REQUIRE(result_layer.key_table().size() == num_properties);
+
+    while (auto result_feature = result_layer.next_feature()) {
+        REQUIRE(result_feature.id() == feature.id());
+        REQUIRE(result_feature.num_properties() == num_properties);
+    }
+}
+
 TEST_CASE("Copy tile using geometry_feature_builder") {
     const auto buffer = load_test_tile();
     vtzero::vector_tile tile{buffer};
@@ -406,3 +487,244 @@ TEST_CASE("Moving a feature builder is allowed") {
     vtzero::point_feature_builder fbuilder3{std::move(fbuilder2)};
 }
 
+TEST_CASE("Rollback layer to savepoint") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    const auto add = [&lbuilder](uint64_t id, const char* value) {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(id);
+        fbuilder.add_point(10, 10);
+        fbuilder.add_property("foo", value);
+        fbuilder.commit();
+    };
+
+    add(1, "a");
+    const auto sp = lbuilder.savepoint();
+
+    SECTION("rollback without changes") {
+        lbuilder.rollback_to(sp);
+    }
+
+    SECTION("rollback features, keys and values") {
+        add(2, "b");
+        lbuilder.add_key("bar");
+        lbuilder.rollback_to(sp);
+        lbuilder.rollback_to(sp);
+    }
+
+    SECTION("rollback with index") {
+        // enough values to make sure the index is used
+        for (uint64_t n = 0; n < 50; ++n) {
+            add(100 + n, std::to_string(n).c_str());
+        }
+        lbuilder.rollback_to(sp);
+    }
+
+    add(3, "c");
+
+    // index values after rollback continue where the savepoint was
+    REQUIRE(lbuilder.add_key("foo").value() == 0);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"a"}).value() == 0);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"c"}).value() == 1);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"b"}).value() == 2);
+
+    const std::string data = tbuilder.serialize();
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.num_features() == 2);
+    REQUIRE(layer.key_table().size() == 1);
+    REQUIRE(layer.value_table().size() == 3);
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.id() == 1);
+    REQUIRE(feature.next_property().value().string_value() == "a");
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 3);
+    REQUIRE(feature.next_property().value().string_value() == "c");
+}
+
+TEST_CASE("Rollback layer with large tables keeps the index") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    // more than 16 entries, so the flat hash index is used
+    for (uint32_t n = 0; n < 40; ++n) {
+        REQUIRE(lbuilder.add_key(std::to_string(n)).value() == n);
+    }
+
+    const auto sp = lbuilder.savepoint();
+    for (uint32_t n = 40; n < 100; ++n) {
+        REQUIRE(lbuilder.add_key(std::to_string(n)).value() == n);
+    }
+    lbuilder.add_key_without_dup_check("7"); // duplicate of a kept entry
+    REQUIRE(lbuilder.add_key("77").value() == 77);
+    lbuilder.rollback_to(sp);
+
+    // kept entries are still found
+    for (uint32_t n = 0; n < 40; ++n) {
+        REQUIRE(lbuilder.add_key(std::to_string(n)).value() == n);
+    }
+
+    // removed entries are added again and deduplicated
+    REQUIRE(lbuilder.add_key("77").value() == 40);
+    REQUIRE(lbuilder.add_key("50").value() == 41);
+    REQUIRE(lbuilder.add_key("77").value() == 40);
+    REQUIRE(lbuilder.add_key("50").value() == 41);
+    REQUIRE(lbuilder.add_key("7").value() == 7);
+
+    // rollback again after the index has seen the new entries
+    const auto sp2 = lbuilder.savepoint();
+    REQUIRE(lbuilder.add_key("x").value() == 42);
+    lbuilder.rollback_to(sp2);
+    REQUIRE(lbuilder.add_key("y").value() == 42);
+    REQUIRE(lbuilder.add_key("77").value() == 40);
+    REQUIRE(lbuilder.add_key("y").value() == 42);
+}
+
+TEST_CASE("Rollback to savepoint of other layer fails") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder1{tbuilder, "test1"};
+    vtzero::layer_builder lbuilder2{tbuilder, "test2"};
+
+    const auto sp = lbuilder1.savepoint();
+    REQUIRE_THROWS_AS(lbuilder2.rollback_to(sp), const assert_error&);
+}
+
+static void test_table_index_policy(const vtzero::table_index_policy policy) {
+    static constexpr const int max_entries = 100;
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    REQUIRE(lbuilder.get_table_index_policy() == vtzero::table_index_policy::automatic);
+    lbuilder.set_table_index_policy(policy);
+    REQUIRE(lbuilder.get_table_index_policy() == policy);
+
+    // entries added without dup check are found later
+    REQUIRE(lbuilder.add_key_without_dup_check("x").value() == 0);
+
+    for (int n = 0; n < max_entries; ++n) {
+        REQUIRE(lbuilder.add_key(std::to_string(n)).value() == n + 1);
+        REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{n}).value() == n);
+    }
+
+    REQUIRE(lbuilder.add_key("x").value() == 0);
+    for (int n = max_entries - 1; n >= 0; --n) {
+        REQUIRE(lbuilder.add_key(std::to_string(n)).value() == n + 1);
+        REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{n}).value() == n);
+    }
+
+    const auto sp = lbuilder.savepoint();
+    REQUIRE(lbuilder.add_key("y").value() == max_entries + 1);
+    lbuilder.rollback_to(sp);
+    REQUIRE(lbuilder.add_key("z").value() == max_entries + 1);
+    REQUIRE(lbuilder.add_key("y").value() == max_entries + 2);
+    REQUIRE(lbuilder.add_key("7").value() == 8);
+}
+
+TEST_CASE("Table index policy automatic") {
+    test_table_index_policy(vtzero::table_index_policy::automatic);
+}
+
+TEST_CASE("Table index policy small_table") {
+    test_table_index_policy(vtzero::table_index_policy::small_table);
+}
+
+TEST_CASE("Table index policy flat_hash") {
+    test_table_index_policy(vtzero::table_index_policy::flat_hash);
+}
+
+TEST_CASE("Table index policy no_dedup") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    lbuilder.set_table_index_policy(vtzero::table_index_policy::no_dedup);
+
+    REQUIRE(lbuilder.add_key("foo").value() == 0);
+    REQUIRE(lbuilder.add_key("foo").value() == 1);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"bar"}).value() == 0);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"bar"}).value() == 1);
+}
+
+static void build_test_layers(vtzero::tile_builder& tbuilder, const vtzero::vector_tile& tile) {
+    auto t = tile;
+    while (auto layer = t.next_layer()) {
+        if (layer.name() == "poi_label") {
+            // rebuild this one layer
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            while (auto feature = layer.next_feature()) {
+                lbuilder.add_feature(feature);
+            }
+        } else if (layer.name() == "water") {
+            tbuilder.add_existing_layer(vtzero::layer_fragment{layer});
+        } else {
+            tbuilder.add_existing_layer(layer);
+        }
+    }
+
+    // empty layer, will not be written
+    vtzero::layer_builder lbuilder{tbuilder, "empty"};
+}
+
+TEST_CASE("Serialize into different buffer types") {
+    const auto buffer = load_test_tile();
+    const vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+    build_test_layers(tbuilder, tile);
+
+    const std::string expected = tbuilder.serialize();
+    REQUIRE(tbuilder.serialized_size() == expected.size());
+
+    // existing layers and fragments are written as they were
+    vtzero::vector_tile new_tile{expected};
+    auto t = tile;
+    while (auto layer = t.next_layer()) {
+        const auto new_layer = new_tile.next_layer();
+        REQUIRE(new_layer);
+        if (layer.name() == "poi_label") {
+            REQUIRE(new_layer.num_features() == layer.num_features());
+        } else {
+            REQUIRE(new_layer.data() == layer.data());
+        }
+    }
+    REQUIRE_FALSE(new_tile.next_layer());
+
+    SECTION("std::vector<char>") {
+        const auto data = tbuilder.serialize<std::vector<char>>();
+        REQUIRE(std::string(data.data(), data.size()) == expected);
+    }
+
+    SECTION("append to std::vector<char>") {
+        std::vector<char> data{'x', 'y'};
+        tbuilder.serialize(data);
+        REQUIRE(data.size() == expected.size() + 2);
+        REQUIRE(std::string(data.data() + 2, data.size() - 2) == expected);
+    }
+
+    SECTION("fixed buffer") {
+        std::vector<char> data(expected.size() + 10, 'x');
+        REQUIRE(tbuilder.serialize(data.data(), data.size()) == expected.size());
+        REQUIRE(std::string(data.data(), expected.size()) == expected);
+        REQUIRE(data.back() == 'x');
+    }
+
+    SECTION("fixed buffer exactly the right size") {
+        std::vector<char> data(expected.size());
+        REQUIRE(tbuilder.serialize(data.data(), data.size()) == expected.size());
+        REQUIRE(std::string(data.data(), data.size()) == expected);
+    }
+
+    SECTION("fixed buffer too small") {
+        std::vector<char> data(expected.size() - 1, 'x');
+        REQUIRE_THROWS_AS(tbuilder.serialize(data.data(), data.size()), const vtzero::buffer_size_exception&);
+        REQUIRE(std::all_of(data.begin(), data.end(), [](char c) { return c == 'x'; }));
+    }
+}
+
+TEST_CASE("Serialize empty tile into fixed buffer") {
+    vtzero::tile_builder tbuilder;
+    REQUIRE(tbuilder.serialized_size() == 0);
+    REQUIRE(tbuilder.serialize(nullptr, 0) == 0);
+    REQUIRE(tbuilder.serialize<std::vector<char>>().empty());
+}
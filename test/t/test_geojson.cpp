@@ -0,0 +1,248 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geojson.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+template <typename T>
+static std::string json_int(T value) {
+    std::string out;
+    vtzero::detail::append_json_int(out, static_cast<int64_t>(value));
+    return out;
+}
+
+static std::string json_double(double value) {
+    std::string out;
+    vtzero::detail::append_json_double(out, value);
+    return out;
+}
+
+static std::string json_string(const char* value) {
+    std::string out;
+    vtzero::detail::append_json_string(out, vtzero::data_view{value});
+    return out;
+}
+
+TEST_CASE("Write integers as JSON") {
+    REQUIRE(json_int(0) == "0");
+    REQUIRE(json_int(7) == "7");
+    REQUIRE(json_int(10) == "10");
+    REQUIRE(json_int(99) == "99");
+    REQUIRE(json_int(100) == "100");
+    REQUIRE(json_int(12345) == "12345");
+    REQUIRE(json_int(-1) == "-1");
+    REQUIRE(json_int(-4096) == "-4096");
+    REQUIRE(json_int(std::numeric_limits<int64_t>::max()) == "9223372036854775807");
+    REQUIRE(json_int(std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+
+    std::string out;
+    vtzero::detail::append_json_uint(out, std::numeric_limits<uint64_t>::max());
+    REQUIRE(out == "18446744073709551615");
+}
+
+TEST_CASE("Write doubles as JSON") {
+    REQUIRE(json_double(0.0) == "0");
+    REQUIRE(json_double(-3.0) == "-3");
+    REQUIRE(json_double(0.1) == "0.1");
+    REQUIRE(json_double(1.5e300) == "1.5e+300");
+    REQUIRE(json_double(std::numeric_limits<double>::infinity()) == "null");
+
+    // at most 17 significant digits reading back as the same value
+    const double values[] = {0.1 + 0.2, 1.0 / 3.0, -122.41941550000001, 37.77492950000001, 5e-324};
+    for (const double d : values) {
+        const auto str = json_double(d);
+        REQUIRE(std::strtod(str.c_str(), nullptr) == d);
+    }
+    REQUIRE(json_double(0.1 + 0.2) == "0.30000000000000004");
+    REQUIRE(json_double(1e21) == "1e+21");
+    REQUIRE(json_double(-2.5e-8) == "-2.5e-08");
+
+    // round-trip safe, but not the shortest representation "5e-324"
+    REQUIRE(json_double(5e-324) == "4.94065645841247e-324");
+
+    std::string out;
+    vtzero::detail::append_json_float(out, 3.3f);
+    REQUIRE(out == "3.3");
+}
+
+static std::string json_fixed(double value, unsigned int decimals) {
+    std::string out;
+    vtzero::detail::append_json_fixed(out, value, decimals);
+    return out;
+}
+
+TEST_CASE("Write doubles with fixed number of decimals as JSON") {
+    REQUIRE(json_fixed(0.0, 3) == "0");
+    REQUIRE(json_fixed(1.5, 0) == "2");
+    REQUIRE(json_fixed(1.25, 3) == "1.25");
+    REQUIRE(json_fixed(-1.25, 3) == "-1.25");
+    REQUIRE(json_fixed(-0.0001, 3) == "0");
+    REQUIRE(json_fixed(0.0012345, 5) == "0.00123");
+    REQUIRE(json_fixed(-122.419415500001, 7) == "-122.4194155");
+    REQUIRE(json_fixed(1e300, 7) == "1e+300");
+}
+
+TEST_CASE("Write strings as JSON") {
+    REQUIRE(json_string("") == "\"\"");
+    REQUIRE(json_string("foo") == "\"foo\"");
+    REQUIRE(json_string("a\"b\\c") == "\"a\\\"b\\\\c\"");
+    REQUIRE(json_string("line\nbreak\ttab") == "\"line\\nbreak\\ttab\"");
+    REQUIRE(json_string("\x01x\x1f") == "\"\\u0001x\\u001f\"");
+    REQUIRE(json_string("\xc3\xa4") == "\"\xc3\xa4\"");
+}
+
+static std::string build_tile() {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("name", "a \"b\"");
+        fbuilder.add_property("num", 42);
+        fbuilder.add_property("real", 1.5);
+        fbuilder.add_property("flag", true);
+        fbuilder.commit();
+    }
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_points(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.commit();
+    }
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.commit();
+    }
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(5, 6);
+        fbuilder.set_point(7, 8);
+        fbuilder.commit();
+    }
+    {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.add_ring(5);
+        fbuilder.set_point(0, 0);
+        fbuilder.set_point(10, 0);
+        fbuilder.set_point(10, 10);
+        fbuilder.set_point(0, 10);
+        fbuilder.set_point(0, 0);
+        fbuilder.add_ring(4);
+        fbuilder.set_point(1, 1);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(2, 1);
+        fbuilder.set_point(1, 1);
+        fbuilder.commit();
+    }
+    {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.add_ring(4);
+        fbuilder.set_point(0, 0);
+        fbuilder.set_point(1, 0);
+        fbuilder.set_point(1, 1);
+        fbuilder.set_point(0, 0);
+        fbuilder.add_ring(4);
+        fbuilder.set_point(5, 5);
+        fbuilder.set_point(6, 5);
+        fbuilder.set_point(6, 6);
+        fbuilder.set_point(5, 5);
+        fbuilder.commit();
+    }
+    return tbuilder.serialize();
+}
+
+TEST_CASE("Write tile as GeoJSON") {
+    const auto data = build_tile();
+    vtzero::vector_tile tile{data};
+
+    std::string out;
+    vtzero::geojson_writer writer{out};
+    writer.add_tile(tile);
+
+    REQUIRE(out ==
+        "{\"type\":\"FeatureCollection\",\"features\":["
+        "{\"type\":\"Feature\",\"layer\":\"test\",\"id\":1,"
+            "\"geometry\":{\"type\":\"Point\",\"coordinates\":[10,20]},"
+            "\"properties\":{\"name\":\"a \\\"b\\\"\",\"num\":42,\"real\":1.5,\"flag\":true}},\n"
+        "{\"type\":\"Feature\",\"layer\":\"test\","
+            "\"geometry\":{\"type\":\"MultiPoint\",\"coordinates\":[[1,2],[3,4]]},\"properties\":{}},\n"
+        "{\"type\":\"Feature\",\"layer\":\"test\","
+            "\"geometry\":{\"type\":\"LineString\",\"coordinates\":[[1,2],[3,4]]},\"properties\":{}},\n"
+        "{\"type\":\"Feature\",\"layer\":\"test\","
+            "\"geometry\":{\"type\":\"MultiLineString\",\"coordinates\":[[[1,2],[3,4]],[[5,6],[7,8]]]},\"properties\":{}},\n"
+        "{\"type\":\"Feature\",\"layer\":\"test\","
+            "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[[0,0],[10,0],[10,10],[0,10],[0,0]],[[1,1],[1,2],[2,1],[1,1]]]},\"properties\":{}},\n"
+        "{\"type\":\"Feature\",\"layer\":\"test\","
+            "\"geometry\":{\"type\":\"MultiPolygon\",\"coordinates\":[[[[0,0],[1,0],[1,1],[0,0]]],[[[5,5],[6,5],[6,6],[5,5]]]]},\"properties\":{}}"
+        "]}\n");
+}
+
+TEST_CASE("Write GeoJSON with WGS84 coordinates") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 4096};
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(2048, 2048);
+    fbuilder.commit();
+    const auto data = tbuilder.serialize();
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    const auto feature = layer.next_feature();
+
+    std::string out;
+    vtzero::geojson_writer writer{out};
+
+    SECTION("zoom 0") {
+        writer.set_tile(0, 0, 0);
+        writer.add_feature(layer, feature);
+        REQUIRE(out.find("\"coordinates\":[0,0]") != std::string::npos);
+    }
+
+    SECTION("zoom 1") {
+        writer.set_tile(1, 1, 0);
+        writer.add_feature(layer, feature);
+        REQUIRE(out.find("\"coordinates\":[90,66.5133]") != std::string::npos);
+    }
+
+    SECTION("zoom 1 with round-trip coordinates") {
+        writer.set_tile(1, 1, 0);
+        writer.set_coordinate_precision(-1);
+        writer.add_feature(layer, feature);
+        REQUIRE(out.find("\"coordinates\":[90,66.51326044311186]") != std::string::npos);
+    }
+
+    SECTION("zoom 1 with 2 decimals") {
+        writer.set_tile(1, 1, 0);
+        writer.set_coordinate_precision(2);
+        writer.add_feature(layer, feature);
+        REQUIRE(out.find("\"coordinates\":[90,66.51]") != std::string::npos);
+    }
+}
+
+TEST_CASE("Write test tile as GeoJSON") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    std::string out;
+    vtzero::geojson_writer writer{out};
+    writer.set_tile(14, 8714, 8017);
+    writer.add_tile(tile);
+
+    REQUIRE(out.size() > data.size());
+    REQUIRE(out.front() == '{');
+    REQUIRE(out.back() == '\n');
+}
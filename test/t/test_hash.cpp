@@ -0,0 +1,68 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/hash.hpp>
+#include <vtzero/index.hpp>
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+TEST_CASE("hash of strings") {
+    const vtzero::hash<std::string> hs{};
+    const vtzero::hash<vtzero::data_view> hd{};
+
+    std::set<std::size_t> hashes;
+    std::string str;
+    for (int n = 0; n < 40; ++n) {
+        REQUIRE(hs(str) == hd(vtzero::data_view{str}));
+        hashes.insert(hs(str));
+        str += 'x';
+    }
+
+    // all different lengths give different hashes
+    REQUIRE(hashes.size() == 40);
+
+    REQUIRE(hs("foo") != hs("bar"));
+    REQUIRE(hs("abcdefgh1") != hs("abcdefgh2"));
+    REQUIRE(hs(std::string{"a\0b", 3}) != hs(std::string{"a\0c", 3}));
+}
+
+TEST_CASE("hash of numbers") {
+    const vtzero::hash<int64_t> hi{};
+    const vtzero::hash<double> hd{};
+
+    REQUIRE(hi(1) != hi(2));
+    REQUIRE(hi(-1) != hi(1));
+    REQUIRE(hd(0.0) == hd(-0.0));
+    REQUIRE(hd(1.5) != hd(2.5));
+}
+
+TEST_CASE("hash of encoded property values") {
+    const vtzero::encoded_property_value v1{"foo"};
+    const vtzero::encoded_property_value v2{"foo"};
+    const vtzero::encoded_property_value v3{17};
+
+    REQUIRE(v1.hash() == v2.hash());
+    REQUIRE(v1.hash() != v3.hash());
+    REQUIRE(vtzero::hash<vtzero::encoded_property_value>{}(v1) == v1.hash());
+}
+
+TEST_CASE("indexes using vtzero::hash_map by default") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    vtzero::key_index<> key_index{lbuilder};
+    vtzero::value_index_internal<> value_index{lbuilder};
+    vtzero::value_index<vtzero::string_value_type, std::string> string_index{lbuilder};
+
+    REQUIRE(key_index("foo").value() == 0);
+    REQUIRE(key_index("bar").value() == 1);
+    REQUIRE(key_index("foo").value() == 0);
+
+    REQUIRE(value_index(vtzero::encoded_property_value{1}).value() == 0);
+    REQUIRE(string_index("x").value() == 1);
+    REQUIRE(value_index(vtzero::encoded_property_value{1}).value() == 0);
+    REQUIRE(string_index("x").value() == 1);
+}
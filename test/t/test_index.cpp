@@ -3,10 +3,13 @@
 
 #include <vtzero/builder.hpp>
 #include <vtzero/index.hpp>
+#include <vtzero/vector_tile.hpp>
 
+#include <limits>
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 TEST_CASE("add keys to layer using key index built into layer") {
     static constexpr const int max_keys = 100;
@@ -91,6 +94,10 @@ TEST_CASE("key index based on std::map") {
     test_key_index<vtzero::key_index<std::map>>();
 }
 
+TEST_CASE("flat key index") {
+    test_key_index<vtzero::key_index_flat>();
+}
+
 template <typename TIndex>
 static void test_value_index_internal() {
     vtzero::tile_builder tbuilder;
@@ -141,6 +148,68 @@ TEST_CASE("internal value index based on std::map") {
     test_value_index_internal<vtzero::value_index_internal<std::map>>();
 }
 
+TEST_CASE("flat value index with encoded values") {
+    test_value_index_internal<vtzero::value_index_flat>();
+}
+
+TEST_CASE("flat value index with different value types") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::value_index_flat index{lbuilder, 10};
+
+    const auto i1 = index("foo");
+    const auto i2 = index(vtzero::int_value_type{6});
+    const auto i3 = index(vtzero::sint_value_type{6});
+    const auto i4 = index(vtzero::uint_value_type{6});
+    const auto i5 = index(vtzero::double_value_type{6.0});
+    const auto i6 = index(vtzero::float_value_type{6.0f});
+    const auto i7 = index(vtzero::bool_value_type{true});
+    const auto i8 = index(vtzero::bool_value_type{false});
+    const auto i9 = index("");
+
+    const std::vector<vtzero::index_value> all{i1, i2, i3, i4, i5, i6, i7, i8, i9};
+    for (std::size_t n = 0; n < all.size(); ++n) {
+        REQUIRE(all[n].value() == n);
+    }
+
+    REQUIRE(index(std::string{"foo"}) == i1);
+    REQUIRE(index(vtzero::data_view{"foo"}) == i1);
+    REQUIRE(index(vtzero::string_value_type{"foo"}) == i1);
+    REQUIRE(index(vtzero::encoded_property_value{"foo"}) == i1);
+    REQUIRE(index(vtzero::encoded_property_value{vtzero::int_value_type{6}}) == i2);
+    REQUIRE(index(vtzero::encoded_property_value{vtzero::sint_value_type{6}}) == i3);
+    REQUIRE(index(vtzero::uint_value_type{6}) == i4);
+    REQUIRE(index(vtzero::encoded_property_value{6.0}) == i5);
+    REQUIRE(index(vtzero::float_value_type{6.0f}) == i6);
+    REQUIRE(index(vtzero::encoded_property_value{true}) == i7);
+    REQUIRE(index(vtzero::bool_value_type{false}) == i8);
+    REQUIRE(index(vtzero::string_value_type{}) == i9);
+
+    const vtzero::encoded_property_value ev{"foo"};
+    REQUIRE(index(vtzero::property_value{ev.data()}) == i1);
+}
+
+TEST_CASE("flat indexes with many entries") {
+    static constexpr const int max_entries = 1000;
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::key_index_flat key_index{lbuilder};
+    vtzero::value_index_flat value_index{lbuilder};
+
+    for (int n = 0; n < max_entries; ++n) {
+        REQUIRE(key_index(std::to_string(n)).value() == n);
+        REQUIRE(value_index(std::to_string(n)).value() == 2 * n);
+        REQUIRE(value_index(vtzero::int_value_type{n}).value() == 2 * n + 1);
+    }
+
+    for (int n = max_entries - 1; n >= 0; --n) {
+        REQUIRE(key_index(std::to_string(n)).value() == n);
+        REQUIRE(value_index(std::to_string(n)).value() == 2 * n);
+        REQUIRE(value_index(vtzero::int_value_type{n}).value() == 2 * n + 1);
+    }
+}
+
 TEST_CASE("external value index") {
     vtzero::tile_builder tbuilder;
     vtzero::layer_builder lbuilder{tbuilder, "test"};
@@ -279,6 +348,11 @@ TEST_CASE("add features using a key index") {
         fbuilder.add_property(index("some_key"), 12);
     }
 
+    SECTION("flat key index") {
+        vtzero::key_index_flat index{lbuilder};
+        fbuilder.add_property(index("some_key"), 12);
+    }
+
     fbuilder.commit();
 
     const std::string data = tbuilder.serialize();
@@ -324,6 +398,11 @@ TEST_CASE("add features using a value index") {
         fbuilder.add_property(key, index(vtzero::encoded_property_value{vtzero::sint_value_type{12}}));
     }
 
+    SECTION("flat value index") {
+        vtzero::value_index_flat index{lbuilder};
+        fbuilder.add_property(key, index(vtzero::sint_value_type{12}));
+    }
+
     fbuilder.commit();
 
     const std::string data = tbuilder.serialize();
@@ -341,3 +420,101 @@ TEST_CASE("add features using a value index") {
     REQUIRE(property.value().sint_value() == 12);
 }
 
+TEST_CASE("dense value index") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::value_index_dense<vtzero::sint_value_type> index{lbuilder, -10, 20};
+
+    const auto i1 = index(-10);
+    const auto i2 = index(9);
+    const auto i3 = index(10);
+    const auto i4 = index(-11);
+    const auto i5 = index(0);
+
+    REQUIRE(i1.value() == 0);
+    REQUIRE(i2.value() == 1);
+    REQUIRE(i3.value() == 2);
+    REQUIRE(i4.value() == 3);
+    REQUIRE(i5.value() == 4);
+
+    REQUIRE(index(-10) == i1);
+    REQUIRE(index(9) == i2);
+    REQUIRE(index(10) == i3);
+    REQUIRE(index(-11) == i4);
+    REQUIRE(index(0) == i5);
+
+    vtzero::value_index_dense<vtzero::uint_value_type> uindex{lbuilder, 1000, 10};
+    REQUIRE(uindex(1005).value() == 5);
+    REQUIRE(uindex(5).value() == 6);
+    REQUIRE(uindex(1005).value() == 5);
+}
+
+TEST_CASE("adaptive value index") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::value_index_adaptive<vtzero::int_value_type> index{lbuilder, 16};
+
+    REQUIRE(index(5).value() == 0);
+    REQUIRE(index(3).value() == 1);
+    REQUIRE(index(12).value() == 2);
+    REQUIRE(index(-2).value() == 3);
+    REQUIRE(index.dense());
+
+    REQUIRE(index(5).value() == 0);
+    REQUIRE(index(3).value() == 1);
+    REQUIRE(index(12).value() == 2);
+    REQUIRE(index(-2).value() == 3);
+
+    // this makes the range too sparse
+    REQUIRE(index(1000).value() == 4);
+    REQUIRE_FALSE(index.dense());
+
+    REQUIRE(index(5).value() == 0);
+    REQUIRE(index(3).value() == 1);
+    REQUIRE(index(12).value() == 2);
+    REQUIRE(index(-2).value() == 3);
+    REQUIRE(index(1000).value() == 4);
+    REQUIRE(index(std::numeric_limits<int64_t>::min()).value() == 5);
+    REQUIRE(index(std::numeric_limits<int64_t>::max()).value() == 6);
+}
+
+TEST_CASE("adaptive value index with extreme values") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::value_index_adaptive<vtzero::uint_value_type> index{lbuilder};
+
+    REQUIRE(index(std::numeric_limits<uint64_t>::max()).value() == 0);
+    REQUIRE(index(0).value() == 1);
+    REQUIRE_FALSE(index.dense());
+    REQUIRE(index(std::numeric_limits<uint64_t>::max()).value() == 0);
+}
+
+TEST_CASE("quantized value index") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::value_index_quantized<vtzero::double_value_type> index{lbuilder, 0.5};
+
+    REQUIRE(index(1.1).value() == 0);
+    REQUIRE(index(0.9).value() == 0);
+    REQUIRE(index(1.3).value() == 1);
+    REQUIRE(index(-7.0).value() == 2);
+    REQUIRE(index(std::numeric_limits<double>::infinity()).value() == 3);
+    REQUIRE(index(std::numeric_limits<double>::infinity()).value() == 3);
+    REQUIRE(index(1e300).value() == 4);
+
+    vtzero::value_index_quantized<vtzero::float_value_type> findex{lbuilder, 0.25};
+    REQUIRE(findex(2.3f).value() == 5);
+    REQUIRE(findex(2.2f).value() == 5);
+
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(1, 1);
+    fbuilder.commit();
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    const auto layer = tile.next_layer();
+    REQUIRE(layer.value(0).double_value() == Approx(1.0));
+    REQUIRE(layer.value(1).double_value() == Approx(1.5));
+    REQUIRE(layer.value(2).double_value() == Approx(-7.0));
+    REQUIRE(layer.value(5).float_value() == Approx(2.25));
+}
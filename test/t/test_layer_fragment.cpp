@@ -0,0 +1,80 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/layer_fragment.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+
+TEST_CASE("default constructed layer fragment") {
+    vtzero::layer_fragment fragment;
+    REQUIRE_FALSE(fragment.valid());
+    REQUIRE_FALSE(fragment);
+}
+
+TEST_CASE("layer fragment from existing layer") {
+    const auto buffer = load_test_tile();
+    vtzero::layer_fragment fragment;
+
+    {
+        // copy tile data so we know the fragment doesn't reference it
+        const std::string copy{buffer};
+        vtzero::vector_tile tile{copy};
+        fragment = vtzero::layer_fragment{tile.get_layer_by_name("water")};
+    }
+
+    REQUIRE(fragment.valid());
+    REQUIRE(fragment.get_layer().name() == "water");
+
+    std::string data1;
+    {
+        vtzero::tile_builder tbuilder;
+        tbuilder.add_existing_layer(fragment);
+        data1 = tbuilder.serialize();
+    }
+
+    vtzero::vector_tile tile{buffer};
+    vtzero::tile_builder tbuilder;
+    tbuilder.add_existing_layer(tile.get_layer_by_name("water"));
+    REQUIRE(data1 == tbuilder.serialize());
+    REQUIRE(data1.size() == tbuilder.serialized_size());
+}
+
+TEST_CASE("layer fragment from layer builder used in many tiles") {
+    vtzero::layer_fragment fragment;
+
+    {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "static"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("foo", "bar");
+        fbuilder.commit();
+        fragment = lbuilder.fragment();
+    }
+
+    for (int n = 0; n < 3; ++n) {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "dynamic"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(static_cast<uint64_t>(n));
+        fbuilder.add_point(n, n);
+        fbuilder.commit();
+        tbuilder.add_existing_layer(fragment);
+
+        const auto data = tbuilder.serialize<std::string>();
+        REQUIRE(data == tbuilder.serialize());
+
+        vtzero::vector_tile tile{data};
+        REQUIRE(tile.count_layers() == 2);
+        auto layer = tile.get_layer_by_name("static");
+        REQUIRE(layer.num_features() == 1);
+        auto feature = layer.next_feature();
+        REQUIRE(feature.id() == 1);
+        auto property = feature.next_property();
+        REQUIRE(property.key() == "foo");
+        REQUIRE(property.value().string_value() == "bar");
+    }
+}
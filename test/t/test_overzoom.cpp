@@ -0,0 +1,231 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/overzoom.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using geom_type = std::vector<std::vector<vtzero::point>>;
+
+struct collect_handler {
+
+    geom_type data;
+
+    void points_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void points_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void points_end() const noexcept {
+    }
+
+    void linestring_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void linestring_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+    void ring_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void ring_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void ring_end(vtzero::ring_type /*type*/) const noexcept {
+    }
+
+    geom_type result() {
+        return data;
+    }
+
+};
+
+static std::string parent_tile() {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 100};
+
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_points(3);
+        fbuilder.set_point(10, 10);
+        fbuilder.set_point(60, 10);
+        fbuilder.set_point(60, 60);
+        fbuilder.add_property("kind", "point");
+        fbuilder.commit();
+    }
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(2);
+        fbuilder.add_linestring_from_container(std::vector<vtzero::point>{{10, 20}, {90, 20}});
+        fbuilder.add_property("kind", "line");
+        fbuilder.commit();
+    }
+    {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(3);
+        fbuilder.add_ring_from_container(std::vector<vtzero::point>{{20, 20}, {80, 20}, {80, 80}, {20, 80}, {20, 20}});
+        fbuilder.add_property("kind", "polygon");
+        fbuilder.add_property("area", 3600);
+        fbuilder.commit();
+    }
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(4);
+        fbuilder.add_point(90, 90);
+        fbuilder.add_property("kind", "corner");
+        fbuilder.commit();
+    }
+
+    return tbuilder.serialize();
+}
+
+TEST_CASE("Overzoom child tile") {
+    const auto parent = parent_tile();
+    const auto data = vtzero::overzoom_tile(parent, 1, 0, 0);
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.name() == "test");
+    REQUIRE(layer.extent() == 100);
+    REQUIRE(layer.num_features() == 3);
+
+    // feature 4 is rejected, keys and values used only by it are not
+    // in the tables
+    REQUIRE(layer.key_table().size() == 2);
+    REQUIRE(layer.value_table().size() == 4);
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.id() == 1);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{20, 20}}}));
+    auto p = feature.next_property();
+    REQUIRE(p.key() == "kind");
+    REQUIRE(p.value().string_value() == "point");
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 2);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{20, 40}, {100, 40}}}));
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 3);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{40, 100}, {40, 40}, {100, 40}, {100, 100}, {40, 100}}}));
+    REQUIRE(feature.num_properties() == 2);
+}
+
+TEST_CASE("Overzoom child tile with buffer") {
+    const auto parent = parent_tile();
+    const auto data = vtzero::overzoom_tile(parent, 1, 1, 1, 10);
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.num_features() == 3);
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.id() == 1);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{20, 20}}}));
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 3);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{-10, -10}, {60, -10}, {60, 60}, {-10, 60}, {-10, -10}}}));
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 4);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{80, 80}}}));
+}
+
+TEST_CASE("Overzoom empty child tile") {
+    const auto parent = parent_tile();
+    REQUIRE(vtzero::overzoom_tile(parent, 3, 7, 0).empty());
+}
+
+TEST_CASE("Overzoom all children at once gives same result as one by one") {
+    const auto buffer = load_test_tile();
+
+    for (uint32_t dz = 0; dz <= 2; ++dz) {
+        const auto children = vtzero::overzoom_tile_children(buffer, dz, 64);
+        REQUIRE(children.size() == (1u << dz) * (1u << dz));
+
+        std::size_t n = 0;
+        for (uint32_t y = 0; y < (1u << dz); ++y) {
+            for (uint32_t x = 0; x < (1u << dz); ++x) {
+                REQUIRE(children[n] == vtzero::overzoom_tile(buffer, dz, x, y, 64));
+                ++n;
+            }
+        }
+    }
+}
+
+TEST_CASE("Overzoom all children only creates layers with features") {
+    const auto parent = parent_tile();
+    const auto children = vtzero::overzoom_tile_children(parent, 3);
+    REQUIRE(children.size() == 64);
+    REQUIRE(children[7].empty());
+
+    std::size_t non_empty = 0;
+    for (const auto& child : children) {
+        if (!child.empty()) {
+            ++non_empty;
+            REQUIRE(vtzero::vector_tile{child}.count_layers() == 1);
+        }
+    }
+    REQUIRE(non_empty > 0);
+    REQUIRE(non_empty < children.size());
+}
+
+TEST_CASE("Overzoom all children with too large dz throws") {
+    const auto parent = parent_tile();
+    REQUIRE_THROWS_AS(vtzero::overzoom_tile_children(parent, 9), const vtzero::exception&);
+    REQUIRE_THROWS_AS(vtzero::overzoom_tile_children(parent, 20), const vtzero::exception&);
+}
+
+TEST_CASE("Overzoom test tile keeps all points") {
+    const auto buffer = load_test_tile();
+    const auto children = vtzero::overzoom_tile_children(buffer, 2);
+
+    const auto count_points = [](const std::string& data) {
+        std::size_t count = 0;
+        vtzero::vector_tile tile{data};
+        while (auto layer = tile.next_layer()) {
+            while (auto feature = layer.next_feature()) {
+                if (feature.geometry_type() == vtzero::GeomType::POINT) {
+                    const auto geom = vtzero::decode_geometry(feature.geometry(), collect_handler{});
+                    for (const auto& part : geom) {
+                        for (const auto& p : part) {
+                            if (p.x >= 0 && p.x < 4096 && p.y >= 0 && p.y < 4096) {
+                                ++count;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return count;
+    };
+
+    std::size_t sum = 0;
+    for (const auto& child : children) {
+        sum += count_points(child);
+    }
+    REQUIRE(sum == count_points(buffer));
+}
@@ -0,0 +1,182 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/requantize.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using geom_type = std::vector<std::vector<vtzero::point>>;
+
+struct collect_handler {
+
+    geom_type data;
+
+    void points_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void points_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void points_end() const noexcept {
+    }
+
+    void linestring_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void linestring_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+    void ring_begin(uint32_t /*count*/) {
+        data.emplace_back();
+    }
+
+    void ring_point(const vtzero::point point) {
+        data.back().push_back(point);
+    }
+
+    void ring_end(vtzero::ring_type /*type*/) const noexcept {
+    }
+
+    geom_type result() {
+        return data;
+    }
+
+};
+
+static std::string requantize(const std::string& input, uint32_t extent) {
+    vtzero::vector_tile tile{input};
+    vtzero::tile_builder tbuilder;
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer.name(), layer.version(), extent};
+        vtzero::requantize_layer(layer, extent, lbuilder);
+    }
+    return tbuilder.serialize();
+}
+
+TEST_CASE("Requantize test tile") {
+    const auto buffer = load_test_tile();
+    const auto data = requantize(buffer, 512);
+    REQUIRE(data.size() < buffer.size());
+
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+
+    while (auto layer = tile.next_layer()) {
+        if (layer.empty()) {
+            continue;
+        }
+        auto new_layer = new_tile.get_layer_by_name(layer.name());
+        REQUIRE(new_layer);
+        REQUIRE(new_layer.extent() == 512);
+        REQUIRE(new_layer.key_table() == layer.key_table());
+        REQUIRE(new_layer.value_table().size() == layer.value_table().size());
+        REQUIRE(new_layer.num_features() <= layer.num_features());
+
+        // the new features are a subsequence of the old features
+        while (auto feature = new_layer.next_feature()) {
+            auto old_feature = layer.next_feature();
+            while (old_feature && (old_feature.id() != feature.id() ||
+                                   old_feature.geometry_type() != feature.geometry_type() ||
+                                   old_feature.num_properties() != feature.num_properties())) {
+                old_feature = layer.next_feature();
+            }
+            REQUIRE(old_feature);
+            while (auto idxs = feature.next_property_indexes()) {
+                const auto old_idxs = old_feature.next_property_indexes();
+                REQUIRE(idxs.key() == old_idxs.key());
+                REQUIRE(idxs.value() == old_idxs.value());
+            }
+            REQUIRE_NOTHROW(vtzero::decode_geometry(feature.geometry(), collect_handler{}));
+        }
+    }
+}
+
+TEST_CASE("Requantize geometries") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 4096};
+
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_points(4);
+        fbuilder.set_point(4095, 4095);
+        fbuilder.set_point(-4, -4);
+        fbuilder.set_point(-5, -5);
+        fbuilder.set_point(-5, -5);
+        fbuilder.add_property("foo", "bar");
+        fbuilder.commit();
+    }
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(2);
+        fbuilder.add_linestring_from_container(std::vector<vtzero::point>{{0, 0}, {1, 1}, {80, 80}});
+        fbuilder.add_linestring_from_container(std::vector<vtzero::point>{{100, 100}, {103, 103}});
+        fbuilder.commit();
+    }
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(3);
+        fbuilder.add_linestring_from_container(std::vector<vtzero::point>{{0, 0}, {3, 3}});
+        fbuilder.commit();
+    }
+    {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(4);
+        // large outer ring with inner ring
+        fbuilder.add_ring_from_container(std::vector<vtzero::point>{{0, 0}, {800, 0}, {800, 800}, {0, 800}, {0, 0}});
+        fbuilder.add_ring_from_container(std::vector<vtzero::point>{{80, 80}, {80, 160}, {160, 160}, {160, 80}, {80, 80}});
+        // small outer ring with inner ring, both vanish
+        fbuilder.add_ring_from_container(std::vector<vtzero::point>{{1000, 1000}, {1003, 1000}, {1003, 1003}, {1000, 1000}});
+        fbuilder.add_ring_from_container(std::vector<vtzero::point>{{1001, 1001}, {1002, 1002}, {1002, 1001}, {1001, 1001}});
+        fbuilder.commit();
+    }
+
+    const auto data = requantize(tbuilder.serialize(), 512);
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.extent() == 512);
+    REQUIRE(layer.num_features() == 3);
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.id() == 1);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{512, 512}, {0, 0}, {-1, -1}, {-1, -1}}}));
+    const auto p = feature.next_property();
+    REQUIRE(p.key() == "foo");
+    REQUIRE(p.value().string_value() == "bar");
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 2);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{0, 0}, {10, 10}}}));
+
+    feature = layer.next_feature();
+    REQUIRE(feature.id() == 4);
+    REQUIRE(vtzero::decode_geometry(feature.geometry(), collect_handler{}) ==
+            (geom_type{{{0, 0}, {100, 0}, {100, 100}, {0, 100}, {0, 0}},
+                       {{10, 10}, {10, 20}, {20, 20}, {20, 10}, {10, 10}}}));
+}
+
+TEST_CASE("Requantize into non-empty layer builder fails") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+    const auto layer = tile.get_layer_by_name("poi_label");
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 512};
+    lbuilder.add_key("foo");
+    REQUIRE_THROWS_AS(vtzero::requantize_layer(layer, 512, lbuilder), const assert_error&);
+}
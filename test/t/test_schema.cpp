@@ -0,0 +1,107 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/schema.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+
+enum road_key : uint32_t {
+    road_class,
+    road_type,
+    road_name,
+    road_ref
+};
+
+static constexpr const auto road_schema = vtzero::make_layer_schema("class", "type", "name", "ref");
+
+static_assert(road_schema.size() == 4, "schema has 4 keys");
+
+TEST_CASE("Find keys in schema") {
+    REQUIRE(road_schema.find("class").value() == road_class);
+    REQUIRE(road_schema.find("type").value() == road_type);
+    REQUIRE(road_schema.find("name").value() == road_name);
+    REQUIRE(road_schema.find("ref").value() == road_ref);
+
+    REQUIRE(std::string{road_schema.key(road_name)} == "name");
+
+    REQUIRE_FALSE(road_schema.find("foo").valid());
+    REQUIRE_FALSE(road_schema.find("").valid());
+    REQUIRE_FALSE(road_schema.find("nam").valid());
+    REQUIRE_FALSE(road_schema.find("names").valid());
+}
+
+TEST_CASE("Find keys in large schema") {
+    constexpr const vtzero::layer_schema<20> schema{
+        "a", "b", "c", "d", "e", "f", "g", "h", "i", "j",
+        "name", "name_en", "name_de", "name_fr", "name_es",
+        "class", "type", "ref", "layer", "oneway"
+    };
+
+    for (uint32_t n = 0; n < schema.size(); ++n) {
+        REQUIRE(schema.find(schema.key(n)).value() == n);
+    }
+    REQUIRE_FALSE(schema.find("name_it").valid());
+}
+
+TEST_CASE("Build layer with schema") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "roads"};
+    vtzero::schema_key_index<4> index{lbuilder, road_schema};
+
+    {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(10, 10);
+        fbuilder.set_point(20, 20);
+        road_schema.add_property<road_name>(fbuilder, "Main Street");
+        road_schema.add_property<road_class>(fbuilder, "primary");
+        fbuilder.add_property(index("ref"), "B7");
+        fbuilder.add_property(index("surface"), "paved");
+        fbuilder.commit();
+    }
+    {
+        vtzero::geometry_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(2);
+        const std::string geom{"\x09\x02\x02", 3};
+        fbuilder.set_geometry(vtzero::geometry{geom, vtzero::GeomType::POINT});
+        road_schema.add_property<road_type>(fbuilder, "bus_stop");
+        fbuilder.commit();
+    }
+
+    const auto data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.key_table().size() == 5);
+    REQUIRE(layer.key(4) == "surface");
+
+    auto feature = layer.next_feature();
+    auto p = feature.next_property();
+    REQUIRE(p.key() == "name");
+    REQUIRE(p.value().string_value() == "Main Street");
+    p = feature.next_property();
+    REQUIRE(p.key() == "class");
+    p = feature.next_property();
+    REQUIRE(p.key() == "ref");
+    REQUIRE(p.value().string_value() == "B7");
+    p = feature.next_property();
+    REQUIRE(p.key() == "surface");
+
+    feature = layer.next_feature();
+    p = feature.next_property();
+    REQUIRE(p.key() == "type");
+    REQUIRE(p.value().string_value() == "bus_stop");
+}
+
+TEST_CASE("Using schema keys in layer without them fails") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "roads"};
+    lbuilder.add_key("foo");
+
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(10, 10);
+    REQUIRE_THROWS_AS(road_schema.add_property<road_name>(fbuilder, "Main Street"), const assert_error&);
+}
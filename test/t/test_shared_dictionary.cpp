@@ -0,0 +1,104 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/shared_dictionary.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+
+TEST_CASE("add keys and values to shared dictionary") {
+    vtzero::shared_dictionary dict;
+
+    REQUIRE(dict.num_keys() == 0);
+    REQUIRE(dict.num_values() == 0);
+
+    REQUIRE(dict.add_key("class").value() == 0);
+    REQUIRE(dict.add_key("type").value() == 1);
+    REQUIRE(dict.add_key("class").value() == 0);
+    REQUIRE(dict.add_value(vtzero::encoded_property_value{"primary"}).value() == 0);
+    REQUIRE(dict.add_value(vtzero::encoded_property_value{17}).value() == 1);
+    REQUIRE(dict.add_value(vtzero::encoded_property_value{"primary"}).value() == 0);
+
+    REQUIRE(dict.num_keys() == 2);
+    REQUIRE(dict.num_values() == 2);
+
+    REQUIRE(dict.find_key("type").value() == 1);
+    REQUIRE_FALSE(dict.find_key("name").valid());
+    REQUIRE(dict.find_value(vtzero::encoded_property_value{17}.data()).value() == 1);
+    REQUIRE_FALSE(dict.find_value(vtzero::encoded_property_value{"17"}.data()).valid());
+
+    // field 3 (keys), length 4, "type"
+    REQUIRE(dict.key_field(1) == vtzero::data_view{"\x1a\x04type"});
+}
+
+static std::string build_tile(const vtzero::shared_dictionary& dict, const char* value) {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    lbuilder.use_dictionary(dict);
+
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(10, 20);
+    fbuilder.add_property("name", "foo");
+    fbuilder.add_property("class", value);
+    fbuilder.add_property("type", value);
+    fbuilder.commit();
+
+    return tbuilder.serialize();
+}
+
+TEST_CASE("build layers using a shared dictionary") {
+    vtzero::shared_dictionary dict;
+    dict.add_key("class");
+    dict.add_key("type");
+    dict.add_key("unused");
+    dict.add_value(vtzero::encoded_property_value{"primary"});
+    dict.add_value(vtzero::encoded_property_value{"secondary"});
+
+    for (const char* value : {"primary", "secondary", "other"}) {
+        const auto data = build_tile(dict, value);
+
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("name", "foo");
+        fbuilder.add_property("class", value);
+        fbuilder.add_property("type", value);
+        fbuilder.commit();
+
+        // same result as without the dictionary
+        REQUIRE(data == tbuilder.serialize());
+
+        vtzero::vector_tile tile{data};
+        auto layer = tile.next_layer();
+        REQUIRE(layer.key_table().size() == 3);
+        REQUIRE(layer.value_table().size() == 2);
+    }
+}
+
+TEST_CASE("rollback in layer using a shared dictionary") {
+    vtzero::shared_dictionary dict;
+    dict.add_key("class");
+    dict.add_key("oneway");
+    dict.add_value(vtzero::encoded_property_value{"primary"});
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    lbuilder.use_dictionary(dict);
+
+    REQUIRE(lbuilder.add_key("name").value() == 0);
+    REQUIRE(lbuilder.add_key("oneway").value() == 1);
+    const auto sp = lbuilder.savepoint();
+    REQUIRE(lbuilder.add_key("class").value() == 2);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"primary"}).value() == 0);
+
+    lbuilder.rollback_to(sp);
+
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"x"}).value() == 0);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"primary"}).value() == 1);
+    REQUIRE(lbuilder.add_key("type").value() == 2);
+    REQUIRE(lbuilder.add_key("class").value() == 3);
+    REQUIRE(lbuilder.add_key("class").value() == 3);
+    REQUIRE(lbuilder.add_key("oneway").value() == 1);
+}
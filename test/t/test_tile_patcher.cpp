@@ -0,0 +1,300 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/tile_patcher.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+#include <vector>
+
+static std::vector<uint64_t> feature_ids(vtzero::layer layer) {
+    std::vector<uint64_t> ids;
+    while (auto feature = layer.next_feature()) {
+        ids.push_back(feature.id());
+    }
+    return ids;
+}
+
+TEST_CASE("Patching a tile without edits returns the same tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    REQUIRE(patcher.serialize() == buffer);
+}
+
+TEST_CASE("Patching a non-existing layer throws") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    REQUIRE_THROWS_AS(patcher.remove_feature("foo", 1), const vtzero::exception&);
+    REQUIRE_THROWS_AS(patcher.patch_layer("foo"), const vtzero::exception&);
+}
+
+TEST_CASE("Remove feature from tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    patcher.remove_feature("waterway_label", 221925711);
+
+    const auto data = patcher.serialize();
+    REQUIRE(data.size() < buffer.size());
+
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+    REQUIRE(new_tile.count_layers() == tile.count_layers());
+
+    const auto layer = new_tile.get_layer_by_name("waterway_label");
+    REQUIRE(layer.num_features() == 3);
+    REQUIRE_FALSE(layer.get_feature_by_id(221925711));
+    REQUIRE(feature_ids(layer) == (std::vector<uint64_t>{221925697, 221925718, 221925713}));
+    REQUIRE(layer.key_table() == tile.get_layer_by_name("waterway_label").key_table());
+    REQUIRE(layer.value_table() == tile.get_layer_by_name("waterway_label").value_table());
+
+    // other layers are unchanged
+    REQUIRE(new_tile.get_layer_by_name("water").data() == tile.get_layer_by_name("water").data());
+}
+
+TEST_CASE("Remove features and then add one") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    patcher.remove_feature("waterway_label", 221925711);
+    patcher.remove_feature("waterway_label", 221925713);
+    {
+        vtzero::point_feature_builder fbuilder{patcher.patch_layer("waterway_label")};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 20);
+        fbuilder.commit();
+    }
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile new_tile{data};
+    const auto layer = new_tile.get_layer_by_name("waterway_label");
+    REQUIRE(feature_ids(layer) == (std::vector<uint64_t>{221925697, 221925718, 1}));
+}
+
+TEST_CASE("Changing the same feature twice throws") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    vtzero::vector_tile tile{buffer};
+    auto layer = tile.get_layer_by_name("waterway_label");
+    const auto feature = layer.get_feature_by_id(221925718);
+    REQUIRE(feature);
+
+    patcher.remove_feature("waterway_label", 221925711);
+    REQUIRE_THROWS_AS(patcher.remove_feature("waterway_label", 221925711), const vtzero::exception&);
+    REQUIRE_THROWS_AS(patcher.replace_feature("waterway_label", 221925711, feature), const vtzero::exception&);
+
+    patcher.replace_feature("waterway_label", 221925713, feature);
+    REQUIRE_THROWS_AS(patcher.remove_feature("waterway_label", 221925713), const vtzero::exception&);
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile new_tile{data};
+    REQUIRE(feature_ids(new_tile.get_layer_by_name("waterway_label")) ==
+            (std::vector<uint64_t>{221925697, 221925718, 221925718}));
+}
+
+TEST_CASE("Replace feature in tile") {
+    std::string other;
+    {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "other"};
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(221925718);
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(10, 10);
+        fbuilder.set_point(20, 20);
+        fbuilder.add_property("class", "canal");
+        fbuilder.add_property("width", 7);
+        fbuilder.commit();
+        tbuilder.serialize(other);
+    }
+    vtzero::vector_tile other_tile{other};
+    auto other_layer = other_tile.next_layer();
+    const auto other_feature = other_layer.next_feature();
+    REQUIRE(other_feature);
+
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+    patcher.replace_feature("waterway_label", 221925718, other_feature);
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+
+    const auto old_layer = tile.get_layer_by_name("waterway_label");
+    auto layer = new_tile.get_layer_by_name("waterway_label");
+    REQUIRE(layer.num_features() == 4);
+    REQUIRE(feature_ids(layer) == (std::vector<uint64_t>{221925697, 221925718, 221925711, 221925713}));
+
+    // existing key "class" is reused, only the new key "width" is appended
+    REQUIRE(layer.key_table().size() == old_layer.key_table().size() + 1);
+    REQUIRE(layer.key_table().back() == "width");
+
+    auto feature = layer.get_feature_by_id(221925718);
+    REQUIRE(feature.geometry().data() == other_feature.geometry().data());
+    REQUIRE(feature.num_properties() == 2);
+    auto p = feature.next_property();
+    REQUIRE(p.key() == "class");
+    REQUIRE(p.value().string_value() == "canal");
+    p = feature.next_property();
+    REQUIRE(p.key() == "width");
+    REQUIRE(p.value().int_value() == 7);
+
+    // untouched features still decode properly with the extended tables
+    feature = layer.get_feature_by_id(221925711);
+    REQUIRE(feature.num_properties() == 10);
+    REQUIRE(feature.next_property().value().string_value() == "river");
+}
+
+TEST_CASE("Add features to layer of tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    {
+        vtzero::point_feature_builder fbuilder{patcher.patch_layer("waterway_label")};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("class", "river");
+        fbuilder.commit();
+    }
+
+    patcher.remove_feature("waterway_label", 221925697);
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+
+    const auto old_layer = tile.get_layer_by_name("waterway_label");
+    auto layer = new_tile.get_layer_by_name("waterway_label");
+    REQUIRE(feature_ids(layer) == (std::vector<uint64_t>{221925718, 221925711, 221925713, 1}));
+    REQUIRE(layer.key_table().size() == old_layer.key_table().size());
+    REQUIRE(layer.value_table().size() == old_layer.value_table().size());
+
+    auto feature = layer.get_feature_by_id(1);
+    REQUIRE(feature.geometry_type() == vtzero::GeomType::POINT);
+    const auto p = feature.next_property();
+    REQUIRE(p.key() == "class");
+    REQUIRE(p.value().string_value() == "river");
+}
+
+static std::vector<std::string> layer_names(const std::string& data) {
+    std::vector<std::string> names;
+    vtzero::vector_tile tile{data};
+    while (auto layer = tile.next_layer()) {
+        names.emplace_back(layer.name());
+    }
+    return names;
+}
+
+TEST_CASE("Remove layers from tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+    REQUIRE(patcher.count_layers() == 12);
+
+    REQUIRE(patcher.remove_layer("road"));
+    REQUIRE(patcher.remove_layer("landuse"));
+    REQUIRE_FALSE(patcher.remove_layer("road"));
+    REQUIRE_FALSE(patcher.remove_layer("foo"));
+    REQUIRE(patcher.count_layers() == 10);
+    REQUIRE_THROWS_AS(patcher.remove_feature("road", 1), const vtzero::exception&);
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+    REQUIRE(new_tile.count_layers() == 10);
+    REQUIRE_FALSE(new_tile.get_layer_by_name("road"));
+    REQUIRE_FALSE(new_tile.get_layer_by_name("landuse"));
+    REQUIRE(new_tile.get_layer_by_name("water").data() == tile.get_layer_by_name("water").data());
+}
+
+TEST_CASE("Rename layer in tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    REQUIRE_THROWS_AS(patcher.rename_layer("foo", "bar"), const vtzero::exception&);
+    patcher.rename_layer("poi_label", "pois");
+    REQUIRE_THROWS_AS(patcher.rename_layer("poi_label", "bar"), const vtzero::exception&);
+
+    // features can be changed using the new name
+    patcher.remove_feature("pois", 1000221314644);
+
+    const auto data = patcher.serialize();
+    vtzero::vector_tile tile{buffer};
+    vtzero::vector_tile new_tile{data};
+    REQUIRE(new_tile.count_layers() == 12);
+    REQUIRE_FALSE(new_tile.get_layer_by_name("poi_label"));
+
+    const auto old_layer = tile.get_layer_by_name("poi_label");
+    const auto layer = new_tile.get_layer_by_name("pois");
+    REQUIRE(layer);
+    REQUIRE(layer.num_features() == old_layer.num_features() - 1);
+    REQUIRE(layer.key_table() == old_layer.key_table());
+    REQUIRE(layer.version() == old_layer.version());
+    REQUIRE(layer.extent() == old_layer.extent());
+}
+
+TEST_CASE("Rename layer without feature changes keeps all other bytes") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_patcher patcher{buffer};
+
+    patcher.rename_layer("poi_label", "poi_labex");
+    auto data = patcher.serialize();
+    REQUIRE(data.size() == buffer.size());
+
+    const auto pos = data.find("poi_labex");
+    REQUIRE(pos != std::string::npos);
+    data[pos + 8] = 'l';
+    REQUIRE(data == buffer);
+}
+
+TEST_CASE("Reorder and extract layers in tile") {
+    const auto buffer = load_test_tile();
+    const auto names = layer_names(buffer);
+    REQUIRE(names.front() == "landuse");
+    REQUIRE(names.back() == "waterway_label");
+
+    vtzero::tile_patcher patcher{buffer};
+
+    SECTION("move layer to front") {
+        patcher.move_layer("waterway_label", 0);
+        auto expected = names;
+        expected.pop_back();
+        expected.insert(expected.begin(), "waterway_label");
+        REQUIRE(layer_names(patcher.serialize()) == expected);
+    }
+
+    SECTION("move layer to end") {
+        patcher.move_layer("landuse", 100);
+        auto expected = names;
+        expected.erase(expected.begin());
+        expected.push_back("landuse");
+        REQUIRE(layer_names(patcher.serialize()) == expected);
+    }
+
+    SECTION("move non-existing layer") {
+        REQUIRE_THROWS_AS(patcher.move_layer("foo", 0), const vtzero::exception&);
+    }
+
+    SECTION("select layers") {
+        patcher.select_layers({"water", "foo", "landuse", "water"});
+        REQUIRE(patcher.count_layers() == 2);
+        const auto data = patcher.serialize();
+        REQUIRE(layer_names(data) == (std::vector<std::string>{"water", "landuse"}));
+
+        vtzero::vector_tile tile{buffer};
+        vtzero::vector_tile new_tile{data};
+        REQUIRE(new_tile.get_layer_by_name("landuse").data() == tile.get_layer_by_name("landuse").data());
+    }
+
+    SECTION("select all layers in original order") {
+        std::vector<vtzero::data_view> all;
+        for (const auto& name : names) {
+            all.emplace_back(name);
+        }
+        patcher.select_layers(all);
+        REQUIRE(patcher.serialize() == buffer);
+    }
+}
@@ -0,0 +1,205 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/wkb.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+static std::string to_hex(const std::string& data) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    for (const char c : data) {
+        const auto b = static_cast<unsigned char>(c);
+        out += digits[b >> 4U];
+        out += digits[b & 0xfU];
+    }
+    return out;
+}
+
+// Little-endian WKB of the doubles 1.0 to 10.0.
+static const char* const d0  = "0000000000000000";
+static const char* const d1  = "000000000000F03F";
+static const char* const d2  = "0000000000000040";
+static const char* const d3  = "0000000000000840";
+static const char* const d4  = "0000000000001040";
+static const char* const d5  = "0000000000001440";
+static const char* const d6  = "0000000000001840";
+static const char* const d10 = "0000000000002440";
+
+template <typename TFunc>
+static std::string wkb_of_feature(TFunc&& build, const uint32_t srid = 0) {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    std::forward<TFunc>(build)(lbuilder);
+    const auto data = tbuilder.serialize();
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    const auto feature = layer.next_feature();
+
+    std::string wkb;
+    if (srid == 0) {
+        vtzero::write_wkb(feature.geometry(), wkb);
+    } else {
+        vtzero::write_ewkb(feature.geometry(), wkb, srid);
+    }
+    return to_hex(wkb);
+}
+
+TEST_CASE("Write point as WKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(1, 2);
+        fbuilder.commit();
+    });
+    REQUIRE(wkb == std::string{"0101000000"} + d1 + d2);
+}
+
+TEST_CASE("Write point as EWKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(1, 2);
+        fbuilder.commit();
+    }, 3857);
+    REQUIRE(wkb == std::string{"0101000020110F0000"} + d1 + d2);
+}
+
+TEST_CASE("Write multipoint as WKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_points(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.commit();
+    });
+    REQUIRE(wkb == std::string{"010400000002000000"} +
+                   "0101000000" + d1 + d2 +
+                   "0101000000" + d3 + d4);
+}
+
+TEST_CASE("Write linestring as WKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.commit();
+    });
+    REQUIRE(wkb == std::string{"010200000002000000"} + d1 + d2 + d3 + d4);
+}
+
+TEST_CASE("Write multilinestring as EWKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(3, 4);
+        fbuilder.add_linestring(2);
+        fbuilder.set_point(5, 6);
+        fbuilder.set_point(1, 2);
+        fbuilder.commit();
+    }, 4326);
+    REQUIRE(wkb == std::string{"0105000020E610000002000000"} +
+                   "010200000002000000" + d1 + d2 + d3 + d4 +
+                   "010200000002000000" + d5 + d6 + d1 + d2);
+}
+
+TEST_CASE("Write polygon with hole as WKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.add_ring(4);
+        fbuilder.set_point(0, 0);
+        fbuilder.set_point(10, 0);
+        fbuilder.set_point(0, 10);
+        fbuilder.set_point(0, 0);
+        fbuilder.add_ring(4);
+        fbuilder.set_point(1, 1);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(2, 1);
+        fbuilder.set_point(1, 1);
+        fbuilder.commit();
+    });
+    REQUIRE(wkb == std::string{"010300000002000000"} +
+                   "04000000" + d0 + d0 + d10 + d0 + d0 + d10 + d0 + d0 +
+                   "04000000" + d1 + d1 + d1 + d2 + d2 + d1 + d1 + d1);
+}
+
+TEST_CASE("Write multipolygon as WKB") {
+    const auto wkb = wkb_of_feature([](vtzero::layer_builder& lbuilder) {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        fbuilder.add_ring(4);
+        fbuilder.set_point(0, 0);
+        fbuilder.set_point(10, 0);
+        fbuilder.set_point(0, 10);
+        fbuilder.set_point(0, 0);
+        fbuilder.add_ring(4);
+        fbuilder.set_point(1, 1);
+        fbuilder.set_point(1, 2);
+        fbuilder.set_point(2, 1);
+        fbuilder.set_point(1, 1);
+        fbuilder.add_ring(4);
+        fbuilder.set_point(3, 3);
+        fbuilder.set_point(4, 3);
+        fbuilder.set_point(3, 4);
+        fbuilder.set_point(3, 3);
+        fbuilder.commit();
+    });
+    REQUIRE(wkb == std::string{"010600000002000000"} +
+                   "010300000002000000" +
+                   "04000000" + d0 + d0 + d10 + d0 + d0 + d10 + d0 + d0 +
+                   "04000000" + d1 + d1 + d1 + d2 + d2 + d1 + d1 + d1 +
+                   "010300000001000000" +
+                   "04000000" + d3 + d3 + d4 + d3 + d3 + d4 + d3 + d3);
+}
+
+TEST_CASE("Write WKB into existing buffer") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::linestring_feature_builder fbuilder{lbuilder};
+    fbuilder.add_linestring(3);
+    fbuilder.set_point(1, 2);
+    fbuilder.set_point(3, 4);
+    fbuilder.set_point(5, 6);
+    fbuilder.commit();
+    const auto data = tbuilder.serialize();
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    const auto feature = layer.next_feature();
+
+    vtzero::wkb_geometry_handler handler;
+    REQUIRE(handler.prepare_size(feature.geometry()) == 1 + 4 + 4 + 3 * 16);
+
+    std::vector<char> buffer(3, 'x');
+    handler.prepare(feature.geometry(), buffer);
+    vtzero::decode_geometry(feature.geometry(), handler);
+    REQUIRE(buffer.size() == 3 + 1 + 4 + 4 + 3 * 16);
+    REQUIRE(buffer[2] == 'x');
+    REQUIRE(buffer[3] == 1);
+    REQUIRE(buffer[4] == 2);
+}
+
+TEST_CASE("Write test tile as WKB") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    vtzero::wkb_geometry_handler handler{3857};
+    std::string wkb;
+    std::size_t features = 0;
+    while (auto layer = tile.next_layer()) {
+        while (const auto feature = layer.next_feature()) {
+            const auto old_size = wkb.size();
+            const auto size = handler.prepare_size(feature.geometry());
+            handler.prepare(feature.geometry(), wkb);
+            vtzero::decode_geometry(feature.geometry(), handler);
+            REQUIRE(wkb.size() == old_size + size);
+            ++features;
+        }
+    }
+    REQUIRE(features > 0);
+}
@@ -0,0 +1,289 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/wkb_import.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace {
+
+    // Writes WKB for the tests, little or big endian.
+    class test_wkb {
+
+        std::string m_data;
+        bool m_little_endian;
+
+        void add_bytes(const char* data, const std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                m_data += m_little_endian ? data[i] : data[size - 1 - i];
+            }
+        }
+
+    public:
+
+        explicit test_wkb(bool little_endian = true) :
+            m_little_endian(little_endian) {
+        }
+
+        test_wkb& header(uint32_t type) {
+            m_data += m_little_endian ? '\1' : '\0';
+            return count(type);
+        }
+
+        test_wkb& count(uint32_t value) {
+            // test assumes little endian host
+            char buffer[4];
+            std::memcpy(buffer, &value, 4);
+            add_bytes(buffer, 4);
+            return *this;
+        }
+
+        test_wkb& coord(double x, double y) {
+            char buffer[8];
+            std::memcpy(buffer, &x, 8);
+            add_bytes(buffer, 8);
+            std::memcpy(buffer, &y, 8);
+            add_bytes(buffer, 8);
+            return *this;
+        }
+
+        vtzero::data_view data() const noexcept {
+            return vtzero::data_view{m_data.data(), m_data.size()};
+        }
+
+    }; // class test_wkb
+
+} // anonymous namespace
+
+// Tile with bounds 0,0 - 100,100 and extent 100: Only flips the y axis.
+static const vtzero::tile_transform transform{0.0, 0.0, 100.0, 100.0, 100, 10};
+
+template <typename TBuilder, typename TFunc>
+static std::string geometry_of(TFunc&& func) {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 100};
+    TBuilder fbuilder{lbuilder};
+    std::forward<TFunc>(func)(fbuilder);
+    fbuilder.commit();
+    const auto data = tbuilder.serialize();
+
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    const auto feature = layer.next_feature();
+    return std::string(feature.geometry().data().data(), feature.geometry().data().size());
+}
+
+TEST_CASE("Tile transform") {
+    REQUIRE(transform(0.0, 0.0) == vtzero::point(0, 100));
+    REQUIRE(transform(10.4, 20.6) == vtzero::point(10, 79));
+    REQUIRE(transform(-50.0, 200.0) == vtzero::point(-10, -10));
+    REQUIRE(transform(1e300, -1e300) == vtzero::point(110, 110));
+    REQUIRE(transform(std::numeric_limits<double>::quiet_NaN(), 5.0) == vtzero::point(-10, 95));
+
+    const auto wm = vtzero::tile_transform::web_mercator(1, 1, 0, 4096);
+    REQUIRE(wm(0.0, 0.0) == vtzero::point(0, 4096));
+    REQUIRE(wm(20037508.342789244, 20037508.342789244) == vtzero::point(4096, 0));
+}
+
+TEST_CASE("Get geometry type of WKB") {
+    REQUIRE(vtzero::wkb_geometry_type(test_wkb{}.header(1).coord(1, 2).data()) == vtzero::GeomType::POINT);
+    REQUIRE(vtzero::wkb_geometry_type(test_wkb{false}.header(5).count(0).data()) == vtzero::GeomType::LINESTRING);
+    REQUIRE(vtzero::wkb_geometry_type(test_wkb{}.header(0x20000006U).count(4326).count(0).data()) == vtzero::GeomType::POLYGON);
+    REQUIRE_THROWS_AS(vtzero::wkb_geometry_type(test_wkb{}.header(7).count(0).data()), const vtzero::geometry_exception&);
+    REQUIRE_THROWS_AS(vtzero::wkb_geometry_type(vtzero::data_view{"\1\1", 2}), const vtzero::geometry_exception&);
+}
+
+TEST_CASE("Add point from WKB") {
+    const auto expected = geometry_of<vtzero::point_feature_builder>([](vtzero::point_feature_builder& fb) {
+        fb.add_point(10, 80);
+    });
+
+    SECTION("little endian") {
+        const auto geom = geometry_of<vtzero::point_feature_builder>([](vtzero::point_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, test_wkb{}.header(1).coord(10.2, 19.9).data(), transform) == 1);
+        });
+        REQUIRE(geom == expected);
+    }
+
+    SECTION("big endian") {
+        const auto geom = geometry_of<vtzero::point_feature_builder>([](vtzero::point_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, test_wkb{false}.header(1).coord(10.2, 19.9).data(), transform) == 1);
+        });
+        REQUIRE(geom == expected);
+    }
+
+    SECTION("EWKB with Z and SRID") {
+        test_wkb wkb;
+        wkb.header(0xa0000001U).count(3857).coord(10.0, 20.0).coord(99.0, 0.0);
+        const auto geom = geometry_of<vtzero::point_feature_builder>([&](vtzero::point_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 1);
+        });
+        REQUIRE(geom == expected);
+    }
+
+    SECTION("ISO WKB with ZM") {
+        test_wkb wkb;
+        wkb.header(3001).coord(10.0, 20.0).coord(1.0, 2.0);
+        const auto geom = geometry_of<vtzero::point_feature_builder>([&](vtzero::point_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 1);
+        });
+        REQUIRE(geom == expected);
+    }
+}
+
+TEST_CASE("Add multipoint from WKB") {
+    const auto expected = geometry_of<vtzero::point_feature_builder>([](vtzero::point_feature_builder& fb) {
+        fb.add_points(2);
+        fb.set_point(10, 80);
+        fb.set_point(30, 60);
+    });
+
+    test_wkb wkb;
+    wkb.header(4).count(4);
+    wkb.header(1).coord(10.0, 20.0);
+    wkb.header(1).coord(10.1, 20.1); // same point in tile coordinates
+    wkb.header(1).coord(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+    wkb.header(1).coord(30.0, 40.0);
+
+    const auto geom = geometry_of<vtzero::point_feature_builder>([&](vtzero::point_feature_builder& fb) {
+        REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 2);
+    });
+    REQUIRE(geom == expected);
+}
+
+TEST_CASE("Add linestring from WKB") {
+    const auto expected = geometry_of<vtzero::linestring_feature_builder>([](vtzero::linestring_feature_builder& fb) {
+        fb.add_linestring(3);
+        fb.set_point(10, 80);
+        fb.set_point(30, 60);
+        fb.set_point(50, 60);
+    });
+
+    test_wkb wkb;
+    wkb.header(2).count(5).coord(10.0, 20.0).coord(30.0, 40.0).coord(30.2, 40.0).coord(29.9, 39.8).coord(50.0, 40.0);
+
+    const auto geom = geometry_of<vtzero::linestring_feature_builder>([&](vtzero::linestring_feature_builder& fb) {
+        REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 1);
+    });
+    REQUIRE(geom == expected);
+}
+
+TEST_CASE("Add multilinestring from WKB dropping degenerate linestrings") {
+    const auto expected = geometry_of<vtzero::linestring_feature_builder>([](vtzero::linestring_feature_builder& fb) {
+        fb.add_linestring(2);
+        fb.set_point(10, 80);
+        fb.set_point(30, 60);
+        fb.add_linestring(2);
+        fb.set_point(1, 99);
+        fb.set_point(2, 98);
+    });
+
+    test_wkb wkb;
+    wkb.header(5).count(3);
+    wkb.header(2).count(2).coord(10.0, 20.0).coord(30.0, 40.0);
+    wkb.header(2).count(2).coord(5.0, 5.0).coord(5.1, 5.1);
+    wkb.header(2).count(2).coord(1.0, 1.0).coord(2.0, 2.0);
+
+    const auto geom = geometry_of<vtzero::linestring_feature_builder>([&](vtzero::linestring_feature_builder& fb) {
+        REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 2);
+    });
+    REQUIRE(geom == expected);
+}
+
+TEST_CASE("Add polygon from WKB fixing winding order") {
+    // outer ring clockwise, inner ring counterclockwise in tile coordinates
+    const auto expected = geometry_of<vtzero::polygon_feature_builder>([](vtzero::polygon_feature_builder& fb) {
+        fb.add_ring(5);
+        fb.set_point(0, 100);
+        fb.set_point(0, 0);
+        fb.set_point(100, 0);
+        fb.set_point(100, 100);
+        fb.set_point(0, 100);
+        fb.add_ring(4);
+        fb.set_point(10, 90);
+        fb.set_point(20, 90);
+        fb.set_point(10, 80);
+        fb.set_point(10, 90);
+    });
+
+    SECTION("rings in OGC order") {
+        test_wkb wkb;
+        wkb.header(3).count(2);
+        wkb.count(5).coord(0, 0).coord(100, 0).coord(100, 100).coord(0, 100).coord(0, 0);
+        wkb.count(4).coord(10, 10).coord(10, 20).coord(20, 10).coord(10, 10);
+        const auto geom = geometry_of<vtzero::polygon_feature_builder>([&](vtzero::polygon_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 2);
+        });
+        REQUIRE(geom == expected);
+    }
+
+    SECTION("rings in reverse order, not closed, with duplicate points") {
+        test_wkb wkb;
+        wkb.header(3).count(2);
+        wkb.count(5).coord(0, 0).coord(0, 100).coord(100, 100).coord(100, 100).coord(100, 0);
+        wkb.count(3).coord(10, 10).coord(20, 10).coord(10, 20);
+        const auto geom = geometry_of<vtzero::polygon_feature_builder>([&](vtzero::polygon_feature_builder& fb) {
+            REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 2);
+        });
+        REQUIRE(geom == expected);
+    }
+}
+
+TEST_CASE("Add multipolygon from WKB dropping degenerate polygons") {
+    const auto expected = geometry_of<vtzero::polygon_feature_builder>([](vtzero::polygon_feature_builder& fb) {
+        fb.add_ring(4);
+        fb.set_point(50, 50);
+        fb.set_point(50, 40);
+        fb.set_point(60, 50);
+        fb.set_point(50, 50);
+    });
+
+    test_wkb wkb;
+    wkb.header(6).count(2);
+    // tiny polygon with a hole, both collapse
+    wkb.header(3).count(2);
+    wkb.count(4).coord(1, 1).coord(1.1, 1).coord(1, 1.1).coord(1, 1);
+    wkb.count(4).coord(1, 1).coord(1, 1.1).coord(1.1, 1).coord(1, 1);
+    wkb.header(3).count(1);
+    wkb.count(4).coord(50, 50).coord(60, 50).coord(50, 60).coord(50, 50);
+
+    const auto geom = geometry_of<vtzero::polygon_feature_builder>([&](vtzero::polygon_feature_builder& fb) {
+        REQUIRE(vtzero::add_geometry_from_wkb(fb, wkb.data(), transform) == 1);
+    });
+    REQUIRE(geom == expected);
+}
+
+TEST_CASE("Add geometry from invalid WKB") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test", 2, 100};
+
+    SECTION("wrong type") {
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        REQUIRE_THROWS_AS(vtzero::add_geometry_from_wkb(fbuilder, test_wkb{}.header(1).coord(1, 2).data(), transform),
+                          const vtzero::geometry_exception&);
+    }
+
+    SECTION("wrong type in multi geometry") {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        REQUIRE_THROWS_AS(vtzero::add_geometry_from_wkb(fbuilder, test_wkb{}.header(4).count(1).header(2).count(0).data(), transform),
+                          const vtzero::geometry_exception&);
+    }
+
+    SECTION("truncated") {
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+        REQUIRE_THROWS_AS(vtzero::add_geometry_from_wkb(fbuilder, test_wkb{}.header(3).count(1).count(1000).coord(1, 2).data(), transform),
+                          const vtzero::geometry_exception&);
+    }
+
+    SECTION("unknown byte order") {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        REQUIRE_THROWS_AS(vtzero::add_geometry_from_wkb(fbuilder, vtzero::data_view{"\2\1\0\0\0", 5}, transform),
+                          const vtzero::geometry_exception&);
+    }
+}